@@ -0,0 +1,586 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DtuReader.h"
+#include "zip.h"
+
+using namespace DtuReader;
+
+bool DtuStringView::operator<(const DtuStringView& other) const
+{
+	size_t nCompareSize = m_nSize < other.m_nSize ? m_nSize : other.m_nSize;
+	int nResult = nCompareSize > 0 ? memcmp(m_pData, other.m_pData, nCompareSize) : 0;
+	if (nResult != 0)
+		return nResult < 0;
+
+	return m_nSize < other.m_nSize;
+}
+
+//////////////////////////////////////////////
+// Scanning helpers: skip JSON text without building values
+//////////////////////////////////////////////
+
+static inline const char* skipWhitespace(const char* p, const char* pEnd)
+{
+	while (p < pEnd && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+		p++;
+	return p;
+}
+
+// p points to the opening quote. Returns pointer past the closing quote, or nullptr.
+static inline const char* skipString(const char* p, const char* pEnd, bool* pHasEscapes = nullptr)
+{
+	p++;
+	while (p < pEnd)
+	{
+		const char* pQuote = (const char*)memchr(p, '"', pEnd - p);
+		if (pQuote == nullptr)
+			return nullptr;
+
+		// count preceding backslashes to see if the quote is escaped
+		const char* pBackslash = pQuote;
+		while (pBackslash > p && pBackslash[-1] == '\\')
+			pBackslash--;
+		if (pHasEscapes && memchr(p, '\\', pQuote - p) != nullptr)
+			*pHasEscapes = true;
+		if (((pQuote - pBackslash) & 1) == 0)
+			return pQuote + 1;
+
+		p = pQuote + 1;
+	}
+	return nullptr;
+}
+
+// p points to the first character of a value. Returns pointer past the value, or nullptr.
+static const char* skipValue(const char* p, const char* pEnd)
+{
+	if (p >= pEnd)
+		return nullptr;
+
+	if (*p == '"')
+		return skipString(p, pEnd);
+
+	if (*p == '{' || *p == '[')
+	{
+		int nDepth = 0;
+		while (p < pEnd)
+		{
+			char c = *p;
+			if (c == '"')
+			{
+				p = skipString(p, pEnd);
+				if (p == nullptr)
+					return nullptr;
+				continue;
+			}
+			if (c == '{' || c == '[')
+			{
+				nDepth++;
+			}
+			else if (c == '}' || c == ']')
+			{
+				if (--nDepth == 0)
+					return p + 1;
+			}
+			p++;
+		}
+		return nullptr;
+	}
+
+	// number or literal
+	while (p < pEnd && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+		p++;
+	return p;
+}
+
+//////////////////////////////////////////////
+// DtuParser: recursive descent parser producing DtuValue trees
+//////////////////////////////////////////////
+
+namespace DtuReader
+{
+	class DtuParser
+	{
+	public:
+		DtuParser(const char* pData, size_t nSize) : m_p(pData), m_pEnd(pData + nSize) {}
+
+		bool parse(DtuValue& value)
+		{
+			if (!parseValue(value, 0))
+				return false;
+			m_p = skipWhitespace(m_p, m_pEnd);
+			return m_p == m_pEnd;
+		}
+
+	private:
+		static const int s_nMaxDepth = 512;
+
+		bool parseValue(DtuValue& value, int nDepth)
+		{
+			m_p = skipWhitespace(m_p, m_pEnd);
+			if (m_p >= m_pEnd || nDepth > s_nMaxDepth)
+				return false;
+
+			const char* pStart = m_p;
+			switch (*m_p)
+			{
+			case '{':
+				return parseObject(value, nDepth);
+			case '[':
+				return parseArray(value, nDepth);
+			case '"':
+			{
+				bool bHasEscapes = false;
+				const char* pAfter = skipString(m_p, m_pEnd, &bHasEscapes);
+				if (pAfter == nullptr)
+					return false;
+				value.m_eType = DtuValueType_String;
+				value.m_Raw = DtuStringView(pStart + 1, (pAfter - 1) - (pStart + 1));
+				value.m_bHasEscapes = bHasEscapes;
+				m_p = pAfter;
+				return true;
+			}
+			default:
+			{
+				const char* pAfter = skipValue(m_p, m_pEnd);
+				if (pAfter == nullptr || pAfter == pStart)
+					return false;
+				value.m_Raw = DtuStringView(pStart, pAfter - pStart);
+				if (value.m_Raw == "null")
+					value.m_eType = DtuValueType_Null;
+				else if (value.m_Raw == "true" || value.m_Raw == "false")
+					value.m_eType = DtuValueType_Bool;
+				else if (*pStart == '-' || (*pStart >= '0' && *pStart <= '9'))
+					value.m_eType = DtuValueType_Number;
+				else
+					return false;
+				m_p = pAfter;
+				return true;
+			}
+			}
+		}
+
+		bool parseArray(DtuValue& value, int nDepth)
+		{
+			const char* pStart = m_p;
+			value.m_eType = DtuValueType_Array;
+			m_p++;
+			m_p = skipWhitespace(m_p, m_pEnd);
+			if (m_p < m_pEnd && *m_p == ']')
+			{
+				m_p++;
+				value.m_Raw = DtuStringView(pStart, m_p - pStart);
+				return true;
+			}
+			while (m_p < m_pEnd)
+			{
+				value.m_aChildren.push_back(DtuValue());
+				if (!parseValue(value.m_aChildren.back(), nDepth + 1))
+					return false;
+				m_p = skipWhitespace(m_p, m_pEnd);
+				if (m_p >= m_pEnd)
+					return false;
+				if (*m_p == ',')
+				{
+					m_p++;
+					continue;
+				}
+				if (*m_p == ']')
+				{
+					m_p++;
+					value.m_Raw = DtuStringView(pStart, m_p - pStart);
+					return true;
+				}
+				return false;
+			}
+			return false;
+		}
+
+		bool parseObject(DtuValue& value, int nDepth)
+		{
+			const char* pStart = m_p;
+			value.m_eType = DtuValueType_Object;
+			m_p++;
+			m_p = skipWhitespace(m_p, m_pEnd);
+			if (m_p < m_pEnd && *m_p == '}')
+			{
+				m_p++;
+				value.m_Raw = DtuStringView(pStart, m_p - pStart);
+				return true;
+			}
+			while (m_p < m_pEnd)
+			{
+				m_p = skipWhitespace(m_p, m_pEnd);
+				if (m_p >= m_pEnd || *m_p != '"')
+					return false;
+				const char* pKeyEnd = skipString(m_p, m_pEnd);
+				if (pKeyEnd == nullptr)
+					return false;
+				value.m_aKeys.push_back(DtuStringView(m_p + 1, (pKeyEnd - 1) - (m_p + 1)));
+				m_p = skipWhitespace(pKeyEnd, m_pEnd);
+				if (m_p >= m_pEnd || *m_p != ':')
+					return false;
+				m_p++;
+				value.m_aChildren.push_back(DtuValue());
+				if (!parseValue(value.m_aChildren.back(), nDepth + 1))
+					return false;
+				m_p = skipWhitespace(m_p, m_pEnd);
+				if (m_p >= m_pEnd)
+					return false;
+				if (*m_p == ',')
+				{
+					m_p++;
+					continue;
+				}
+				if (*m_p == '}')
+				{
+					m_p++;
+					value.m_Raw = DtuStringView(pStart, m_p - pStart);
+					return true;
+				}
+				return false;
+			}
+			return false;
+		}
+
+		const char* m_p;
+		const char* m_pEnd;
+	};
+}
+
+//////////////////////////////////////////////
+// DtuValue
+//////////////////////////////////////////////
+
+static void appendUtf8(std::string& sResult, unsigned int nCodePoint)
+{
+	if (nCodePoint < 0x80)
+	{
+		sResult += (char)nCodePoint;
+	}
+	else if (nCodePoint < 0x800)
+	{
+		sResult += (char)(0xC0 | (nCodePoint >> 6));
+		sResult += (char)(0x80 | (nCodePoint & 0x3F));
+	}
+	else if (nCodePoint < 0x10000)
+	{
+		sResult += (char)(0xE0 | (nCodePoint >> 12));
+		sResult += (char)(0x80 | ((nCodePoint >> 6) & 0x3F));
+		sResult += (char)(0x80 | (nCodePoint & 0x3F));
+	}
+	else
+	{
+		sResult += (char)(0xF0 | (nCodePoint >> 18));
+		sResult += (char)(0x80 | ((nCodePoint >> 12) & 0x3F));
+		sResult += (char)(0x80 | ((nCodePoint >> 6) & 0x3F));
+		sResult += (char)(0x80 | (nCodePoint & 0x3F));
+	}
+}
+
+static bool readHex4(const char* p, const char* pEnd, unsigned int& nValue)
+{
+	if (pEnd - p < 4)
+		return false;
+	nValue = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		char c = p[i];
+		nValue <<= 4;
+		if (c >= '0' && c <= '9') nValue |= c - '0';
+		else if (c >= 'a' && c <= 'f') nValue |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') nValue |= c - 'A' + 10;
+		else return false;
+	}
+	return true;
+}
+
+std::string DtuValue::asString() const
+{
+	if (!m_bHasEscapes)
+		return m_Raw.toString();
+
+	std::string sResult;
+	sResult.reserve(m_Raw.size());
+	const char* p = m_Raw.data();
+	const char* pEnd = p + m_Raw.size();
+	while (p < pEnd)
+	{
+		if (*p != '\\' || p + 1 >= pEnd)
+		{
+			sResult += *p++;
+			continue;
+		}
+		p++;
+		char c = *p++;
+		switch (c)
+		{
+		case 'b': sResult += '\b'; break;
+		case 'f': sResult += '\f'; break;
+		case 'n': sResult += '\n'; break;
+		case 'r': sResult += '\r'; break;
+		case 't': sResult += '\t'; break;
+		case 'u':
+		{
+			unsigned int nCodePoint = 0;
+			if (!readHex4(p, pEnd, nCodePoint))
+				break;
+			p += 4;
+			// surrogate pair
+			unsigned int nLow = 0;
+			if (nCodePoint >= 0xD800 && nCodePoint <= 0xDBFF && pEnd - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+				readHex4(p + 2, pEnd, nLow) && nLow >= 0xDC00 && nLow <= 0xDFFF)
+			{
+				nCodePoint = 0x10000 + ((nCodePoint - 0xD800) << 10) + (nLow - 0xDC00);
+				p += 6;
+			}
+			appendUtf8(sResult, nCodePoint);
+			break;
+		}
+		default:
+			// \" \\ \/
+			sResult += c;
+			break;
+		}
+	}
+	return sResult;
+}
+
+double DtuValue::asNumber(double dDefault) const
+{
+	if (m_eType != DtuValueType_Number)
+		return dDefault;
+
+	char buffer[64];
+	size_t nLength = m_Raw.size() < sizeof(buffer) - 1 ? m_Raw.size() : sizeof(buffer) - 1;
+	memcpy(buffer, m_Raw.data(), nLength);
+	buffer[nLength] = '\0';
+
+	return strtod(buffer, nullptr);
+}
+
+bool DtuValue::asBool(bool bDefault) const
+{
+	if (m_eType != DtuValueType_Bool)
+		return bDefault;
+
+	return m_Raw == "true";
+}
+
+const DtuValue* DtuValue::find(const char* sKey) const
+{
+	DtuStringView key(sKey, strlen(sKey));
+	for (size_t i = 0; i < m_aKeys.size(); i++)
+	{
+		if (m_aKeys[i] == key)
+			return &m_aChildren[i];
+	}
+	return nullptr;
+}
+
+//////////////////////////////////////////////
+// DtuDocument
+//////////////////////////////////////////////
+
+DtuDocument::DtuDocument()
+{
+	m_pData = nullptr;
+	m_nSize = 0;
+}
+
+DtuDocument::~DtuDocument()
+{
+	close();
+}
+
+void DtuDocument::close()
+{
+	m_mParsedSections.clear();
+	m_aSections.clear();
+	m_Buffer.clear();
+	m_pData = nullptr;
+	m_nSize = 0;
+	m_sError.clear();
+}
+
+bool DtuDocument::open(const std::string& sFilename)
+{
+	close();
+
+	FILE* pFile = fopen(sFilename.c_str(), "rb");
+	if (pFile == nullptr)
+	{
+		m_sError = "Unable to open file: " + sFilename;
+		return false;
+	}
+	char header[4] = { 0 };
+	size_t nHeaderSize = fread(header, 1, sizeof(header), pFile);
+
+	if (nHeaderSize == 4 && memcmp(header, "PK\x03\x04", 4) == 0)
+	{
+		// Compressed DTU: zip archive with the DTU as first entry
+		fclose(pFile);
+		struct zip_t* zip = zip_open(sFilename.c_str(), 0, 'r');
+		if (zip == nullptr || zip_entry_openbyindex(zip, 0) != 0)
+		{
+			if (zip)
+				zip_close(zip);
+			m_sError = "Unable to open compressed DTU: " + sFilename;
+			return false;
+		}
+		unsigned long long nEntrySize = zip_entry_size(zip);
+		m_Buffer.resize((size_t)nEntrySize);
+		ssize_t nRead = nEntrySize > 0 ? zip_entry_noallocread(zip, &m_Buffer[0], m_Buffer.size()) : 0;
+		zip_entry_close(zip);
+		zip_close(zip);
+		if (nRead < 0 || (unsigned long long)nRead != nEntrySize)
+		{
+			m_Buffer.clear();
+			m_sError = "Unable to decompress DTU: " + sFilename;
+			return false;
+		}
+	}
+	else
+	{
+		fseek(pFile, 0, SEEK_END);
+		long nFileSize = ftell(pFile);
+		fseek(pFile, 0, SEEK_SET);
+		m_Buffer.resize(nFileSize > 0 ? (size_t)nFileSize : 0);
+		size_t nRead = nFileSize > 0 ? fread(&m_Buffer[0], 1, m_Buffer.size(), pFile) : 0;
+		fclose(pFile);
+		if (nRead != m_Buffer.size())
+		{
+			m_Buffer.clear();
+			m_sError = "Unable to read file: " + sFilename;
+			return false;
+		}
+	}
+
+	m_pData = m_Buffer.empty() ? nullptr : &m_Buffer[0];
+	m_nSize = m_Buffer.size();
+
+	return scanSections();
+}
+
+bool DtuDocument::openBuffer(const char* pData, size_t nSize)
+{
+	close();
+	m_pData = pData;
+	m_nSize = nSize;
+
+	return scanSections();
+}
+
+bool DtuDocument::scanSections()
+{
+	const char* p = m_pData;
+	const char* pEnd = m_pData + m_nSize;
+
+	// skip UTF-8 BOM
+	if (m_nSize >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0)
+		p += 3;
+
+	p = skipWhitespace(p, pEnd);
+	if (p >= pEnd || *p != '{')
+	{
+		m_sError = "DTU does not start with a JSON object";
+		return false;
+	}
+	p = skipWhitespace(p + 1, pEnd);
+	if (p < pEnd && *p == '}')
+		return true;
+
+	while (p < pEnd)
+	{
+		if (*p != '"')
+		{
+			m_sError = "Expected section name";
+			return false;
+		}
+		const char* pNameEnd = skipString(p, pEnd);
+		if (pNameEnd == nullptr)
+		{
+			m_sError = "Unterminated section name";
+			return false;
+		}
+		DtuSection section;
+		section.Name = DtuStringView(p + 1, (pNameEnd - 1) - (p + 1));
+
+		p = skipWhitespace(pNameEnd, pEnd);
+		if (p >= pEnd || *p != ':')
+		{
+			m_sError = "Expected ':' after section " + section.Name.toString();
+			return false;
+		}
+		p = skipWhitespace(p + 1, pEnd);
+		const char* pValueEnd = skipValue(p, pEnd);
+		if (pValueEnd == nullptr || pValueEnd == p)
+		{
+			m_sError = "Invalid value for section " + section.Name.toString();
+			return false;
+		}
+		section.RawValue = DtuStringView(p, pValueEnd - p);
+		m_aSections.push_back(section);
+
+		p = skipWhitespace(pValueEnd, pEnd);
+		if (p < pEnd && *p == ',')
+		{
+			p = skipWhitespace(p + 1, pEnd);
+			continue;
+		}
+		if (p < pEnd && *p == '}')
+			return true;
+
+		m_sError = "Expected ',' or '}' after section " + section.Name.toString();
+		return false;
+	}
+
+	m_sError = "Unexpected end of DTU";
+	return false;
+}
+
+const DtuSection* DtuDocument::findSection(const char* sName) const
+{
+	DtuStringView name(sName, strlen(sName));
+	for (size_t i = 0; i < m_aSections.size(); i++)
+	{
+		if (m_aSections[i].Name == name)
+			return &m_aSections[i];
+	}
+	return nullptr;
+}
+
+const DtuValue* DtuDocument::getSection(const char* sName)
+{
+	const DtuSection* pSection = findSection(sName);
+	if (pSection == nullptr)
+		return nullptr;
+
+	auto cached = m_mParsedSections.find(pSection->Name);
+	if (cached != m_mParsedSections.end())
+		return cached->second.get();
+
+	std::unique_ptr<DtuValue> pValue(new DtuValue());
+	DtuParser parser(pSection->RawValue.data(), pSection->RawValue.size());
+	if (!parser.parse(*pValue))
+	{
+		m_sError = "Unable to parse section " + pSection->Name.toString();
+		return nullptr;
+	}
+	const DtuValue* pResult = pValue.get();
+	m_mParsedSections[pSection->Name] = std::move(pValue);
+
+	return pResult;
+}
+
+bool DtuDocument::parseAllSections()
+{
+	bool bResult = true;
+	for (size_t i = 0; i < m_aSections.size(); i++)
+	{
+		std::string sName = m_aSections[i].Name.toString();
+		if (getSection(sName.c_str()) == nullptr)
+			bResult = false;
+	}
+	return bResult;
+}
@@ -0,0 +1,165 @@
+#pragma once
+//////////////////////////////////////////////
+//
+// DtuReader
+//
+// Small, SDK-independent reader for DTU files written by DzBridgeAction.
+// Top-level sections ("Materials", "Morphs", "MorphLinks", etc) are located by a
+// single scanning pass that does not build a DOM. Individual sections are parsed
+// only when requested. All strings returned are views into the loaded file buffer.
+// Compressed DTU files (zip archive with a single entry) are read transparently.
+//
+// Usage:
+//	DtuReader::DtuDocument dtu;
+//	if (dtu.open("C:/Root/Export/Genesis8.dtu"))
+//	{
+//		const DtuReader::DtuValue* pMaterials = dtu.getSection("Materials");
+//		for (size_t i = 0; pMaterials && i < pMaterials->size(); i++)
+//		{
+//			const DtuReader::DtuValue* pName = pMaterials->at(i).find("Material Name");
+//		}
+//	}
+//
+//////////////////////////////////////////////
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+
+namespace DtuReader
+{
+	/// <summary>
+	/// Non-owning view of a character range inside a DtuDocument buffer.
+	/// Only valid as long as the DtuDocument which produced it.
+	/// </summary>
+	class DtuStringView
+	{
+	public:
+		DtuStringView() : m_pData(nullptr), m_nSize(0) {}
+		DtuStringView(const char* pData, size_t nSize) : m_pData(pData), m_nSize(nSize) {}
+
+		const char* data() const { return m_pData; }
+		size_t size() const { return m_nSize; }
+		bool empty() const { return m_nSize == 0; }
+		std::string toString() const { return std::string(m_pData, m_nSize); }
+
+		bool operator==(const DtuStringView& other) const { return m_nSize == other.m_nSize && (m_nSize == 0 || memcmp(m_pData, other.m_pData, m_nSize) == 0); }
+		bool operator!=(const DtuStringView& other) const { return !(*this == other); }
+		bool operator==(const char* sOther) const { return *this == DtuStringView(sOther, strlen(sOther)); }
+		bool operator!=(const char* sOther) const { return !(*this == sOther); }
+		bool operator<(const DtuStringView& other) const;
+
+	private:
+		const char* m_pData;
+		size_t m_nSize;
+	};
+
+	enum DtuValueType
+	{
+		DtuValueType_Null,
+		DtuValueType_Bool,
+		DtuValueType_Number,
+		DtuValueType_String,
+		DtuValueType_Array,
+		DtuValueType_Object
+	};
+
+	/// <summary>
+	/// Parsed JSON value.  Strings and numbers keep a view of their text in the file buffer;
+	/// arrays and objects own their children.
+	/// </summary>
+	class DtuValue
+	{
+	public:
+		DtuValue() : m_eType(DtuValueType_Null), m_bHasEscapes(false) {}
+
+		DtuValueType getType() const { return m_eType; }
+		bool isNull() const { return m_eType == DtuValueType_Null; }
+		bool isObject() const { return m_eType == DtuValueType_Object; }
+		bool isArray() const { return m_eType == DtuValueType_Array; }
+		bool isString() const { return m_eType == DtuValueType_String; }
+		bool isNumber() const { return m_eType == DtuValueType_Number; }
+
+		// Raw text of a string (without quotes, escapes not resolved), number or literal
+		DtuStringView getRaw() const { return m_Raw; }
+		// If false, getRaw() of a string is identical to its unescaped value
+		bool hasEscapes() const { return m_bHasEscapes; }
+		// String with escape sequences resolved (allocates)
+		std::string asString() const;
+		double asNumber(double dDefault = 0.0) const;
+		int asInt(int nDefault = 0) const { return isNumber() ? (int)asNumber() : nDefault; }
+		bool asBool(bool bDefault = false) const;
+
+		// Array items or Object member values
+		size_t size() const { return m_aChildren.size(); }
+		const DtuValue& at(size_t nIndex) const { return m_aChildren[nIndex]; }
+		// Object member names, same order as at()
+		DtuStringView keyAt(size_t nIndex) const { return m_aKeys[nIndex]; }
+		// Linear lookup of an Object member, returns nullptr if not found
+		const DtuValue* find(const char* sKey) const;
+
+	private:
+		friend class DtuParser;
+
+		DtuValueType m_eType;
+		DtuStringView m_Raw;
+		bool m_bHasEscapes;
+		std::vector<DtuValue> m_aChildren;
+		std::vector<DtuStringView> m_aKeys;
+	};
+
+	/// <summary>
+	/// Location of one top-level member of the DTU object.
+	/// </summary>
+	struct DtuSection
+	{
+		DtuStringView Name;
+		DtuStringView RawValue; // complete JSON text of the member value
+	};
+
+	/// <summary>
+	/// DTU file loaded into memory with an index of its top-level sections.
+	/// </summary>
+	class DtuDocument
+	{
+	public:
+		DtuDocument();
+		~DtuDocument();
+
+		// Loads a DTU file (plain or compressed) and scans its top-level sections
+		bool open(const std::string& sFilename);
+		// Scans a DTU held in memory.  The buffer is not copied and must outlive the document.
+		bool openBuffer(const char* pData, size_t nSize);
+		void close();
+
+		const std::string& getError() const { return m_sError; }
+		// Loaded (and decompressed) DTU text
+		const char* getData() const { return m_pData; }
+		size_t getSize() const { return m_nSize; }
+
+		const std::vector<DtuSection>& getSections() const { return m_aSections; }
+		bool hasSection(const char* sName) const { return findSection(sName) != nullptr; }
+		const DtuSection* findSection(const char* sName) const;
+
+		// Parses the section on first request and caches the result.  Returns nullptr if the
+		// section does not exist or is not valid JSON.
+		const DtuValue* getSection(const char* sName);
+
+		// Parses all sections, equivalent to reading the whole file with a DOM parser
+		bool parseAllSections();
+
+	private:
+		bool scanSections();
+
+		std::vector<char> m_Buffer;
+		const char* m_pData;
+		size_t m_nSize;
+		std::string m_sError;
+		std::vector<DtuSection> m_aSections;
+		std::map<DtuStringView, std::unique_ptr<DtuValue>> m_mParsedSections;
+	};
+
+}
@@ -0,0 +1,197 @@
+//////////////////////////////////////////////
+//
+// DtuReaderBenchmark
+//
+// Compares reading a single DTU section with lazy section parsing against parsing
+// the whole DTU, the way JSON.parse() or a DOM parser would.
+//
+// Usage:
+//	DtuReaderBenchmark [file.dtu] [--scale N] [--iterations N]
+//
+// Without a DTU file, a synthetic DTU resembling a fully morphed Genesis character
+// is generated with <scale> times 1,000 morphs and 100 materials.
+//
+//////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+#include "DtuReader.h"
+
+using namespace DtuReader;
+
+static std::string makeSyntheticDtu(int nScale)
+{
+	std::string sDtu;
+	sDtu.reserve((size_t)nScale * 8 * 1024 * 1024);
+	char buffer[512];
+
+	sDtu += "{\n\t\"DTU Version\" : 4,\n\t\"Asset Name\" : \"Benchmark\",\n\t\"Asset Type\" : \"SkeletalMesh\",\n";
+	sDtu += "\t\"FBX File\" : \"C:/Root/Benchmark/Benchmark.fbx\",\n";
+
+	sDtu += "\t\"Materials\" : [\n";
+	int nNumMaterials = 100 * nScale;
+	for (int i = 0; i < nNumMaterials; i++)
+	{
+		snprintf(buffer, sizeof(buffer), "\t\t{\n\t\t\t\"Version\" : 4,\n\t\t\t\"Asset Name\" : \"Genesis8Female\",\n\t\t\t\"Material Name\" : \"Material_%d\",\n\t\t\t\"Material Type\" : \"Iray Uber\",\n\t\t\t\"Properties\" : [\n", i);
+		sDtu += buffer;
+		for (int j = 0; j < 120; j++)
+		{
+			snprintf(buffer, sizeof(buffer), "\t\t\t\t{\n\t\t\t\t\t\"Name\" : \"Property %d\",\n\t\t\t\t\t\"Label\" : \"Property \\\"%d\\\"\",\n\t\t\t\t\t\"Value\" : %g,\n\t\t\t\t\t\"Data Type\" : \"Double\",\n\t\t\t\t\t\"Texture\" : \"%s\"\n\t\t\t\t}%s\n",
+				j, j, j * 0.25, (j % 10 == 0) ? "/Runtime/Textures/Benchmark/Diffuse.jpg" : "", (j < 119) ? "," : "");
+			sDtu += buffer;
+		}
+		sDtu += (i < nNumMaterials - 1) ? "\t\t\t]\n\t\t},\n" : "\t\t\t]\n\t\t}\n";
+	}
+	sDtu += "\t],\n";
+
+	int nNumMorphs = 1000 * nScale;
+	sDtu += "\t\"Morphs\" : [\n";
+	for (int i = 0; i < nNumMorphs; i++)
+	{
+		snprintf(buffer, sizeof(buffer), "\t\t{\n\t\t\t\"Name\" : \"facs_morph_%d\",\n\t\t\t\"Label\" : \"Facs Morph %d\"\n\t\t}%s\n", i, i, (i < nNumMorphs - 1) ? "," : "");
+		sDtu += buffer;
+	}
+	sDtu += "\t],\n";
+
+	sDtu += "\t\"MorphLinks\" : {\n";
+	for (int i = 0; i < nNumMorphs; i++)
+	{
+		snprintf(buffer, sizeof(buffer), "\t\t\"facs_morph_%d\" : {\n\t\t\t\"Label\" : \"Facs Morph %d\",\n\t\t\t\"Links\" : [\n", i, i);
+		sDtu += buffer;
+		for (int j = 0; j < 4; j++)
+		{
+			snprintf(buffer, sizeof(buffer), "\t\t\t\t{\n\t\t\t\t\t\"Bone\" : \"None\",\n\t\t\t\t\t\"Property\" : \"CTRLMorph_%d\",\n\t\t\t\t\t\"Type\" : 0,\n\t\t\t\t\t\"Scalar\" : %g,\n\t\t\t\t\t\"Addend\" : 0\n\t\t\t\t}%s\n",
+				j, 1.0 / (j + 1), (j < 3) ? "," : "");
+			sDtu += buffer;
+		}
+		sDtu += "\t\t\t],\n\t\t\t\"SubLinks\" : [],\n\t\t\t\"Minimum\" : 0,\n\t\t\t\"Maximum\" : 1,\n\t\t\t\"isHidden\" : false\n";
+		sDtu += (i < nNumMorphs - 1) ? "\t\t},\n" : "\t\t}\n";
+	}
+	sDtu += "\t},\n";
+
+	sDtu += "\t\"LimitData\" : {\n";
+	for (int i = 0; i < 200; i++)
+	{
+		snprintf(buffer, sizeof(buffer), "\t\t\"bone_%d\" : [ \"bone_%d\", \"XYZ\", -45, 45, -30, 30, -90, 90 ]%s\n", i, i, (i < 199) ? "," : "");
+		sDtu += buffer;
+	}
+	sDtu += "\t}\n}\n";
+
+	return sDtu;
+}
+
+typedef std::chrono::high_resolution_clock BenchmarkClock;
+
+static double elapsedMs(BenchmarkClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count();
+}
+
+static size_t countTexturedProperties(const DtuValue* pMaterials)
+{
+	size_t nCount = 0;
+	for (size_t i = 0; pMaterials && i < pMaterials->size(); i++)
+	{
+		const DtuValue* pProperties = pMaterials->at(i).find("Properties");
+		for (size_t j = 0; pProperties && j < pProperties->size(); j++)
+		{
+			const DtuValue* pTexture = pProperties->at(j).find("Texture");
+			if (pTexture && !pTexture->getRaw().empty())
+				nCount++;
+		}
+	}
+	return nCount;
+}
+
+int main(int argc, char** argv)
+{
+	std::string sFilename;
+	int nScale = 4;
+	int nIterations = 5;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+			nScale = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+			nIterations = atoi(argv[++i]);
+		else
+			sFilename = argv[i];
+	}
+	if (nScale < 1) nScale = 1;
+	if (nIterations < 1) nIterations = 1;
+
+	std::string sSynthetic;
+	DtuDocument fileDocument;
+	const char* pData = nullptr;
+	size_t nSize = 0;
+	if (sFilename.empty())
+	{
+		sSynthetic = makeSyntheticDtu(nScale);
+		pData = sSynthetic.data();
+		nSize = sSynthetic.size();
+		printf("Synthetic DTU: scale %d, %.1f MB\n", nScale, nSize / (1024.0 * 1024.0));
+	}
+	else
+	{
+		BenchmarkClock::time_point start = BenchmarkClock::now();
+		if (!fileDocument.open(sFilename))
+		{
+			printf("ERROR: %s\n", fileDocument.getError().c_str());
+			return 1;
+		}
+		printf("Loaded %s in %.2f ms\n", sFilename.c_str(), elapsedMs(start));
+		// reuse the loaded (and possibly decompressed) buffer for the timed runs
+		pData = fileDocument.getData();
+		nSize = fileDocument.getSize();
+		printf("DTU size: %.1f MB\n", nSize / (1024.0 * 1024.0));
+	}
+
+	double dScanMs = 0.0, dLazyMs = 0.0, dFullMs = 0.0;
+	size_t nLazyCount = 0, nFullCount = 0, nSections = 0;
+	for (int i = 0; i < nIterations; i++)
+	{
+		BenchmarkClock::time_point start = BenchmarkClock::now();
+		DtuDocument scanDocument;
+		if (!scanDocument.openBuffer(pData, nSize))
+		{
+			printf("ERROR: %s\n", scanDocument.getError().c_str());
+			return 1;
+		}
+		nSections = scanDocument.getSections().size();
+		dScanMs += elapsedMs(start);
+
+		start = BenchmarkClock::now();
+		DtuDocument lazyDocument;
+		lazyDocument.openBuffer(pData, nSize);
+		nLazyCount = countTexturedProperties(lazyDocument.getSection("Materials"));
+		dLazyMs += elapsedMs(start);
+
+		start = BenchmarkClock::now();
+		DtuDocument fullDocument;
+		fullDocument.openBuffer(pData, nSize);
+		if (!fullDocument.parseAllSections())
+		{
+			printf("ERROR: %s\n", fullDocument.getError().c_str());
+			return 1;
+		}
+		nFullCount = countTexturedProperties(fullDocument.getSection("Materials"));
+		dFullMs += elapsedMs(start);
+	}
+
+	printf("Sections: %d, textured material properties: %d\n", (int)nSections, (int)nLazyCount);
+	printf("Scan sections only:           %8.2f ms\n", dScanMs / nIterations);
+	printf("Scan + parse \"Materials\":     %8.2f ms\n", dLazyMs / nIterations);
+	printf("Parse all sections (DOM):     %8.2f ms\n", dFullMs / nIterations);
+
+	if (nLazyCount != nFullCount)
+	{
+		printf("ERROR: lazy and full parse results differ (%d != %d)\n", (int)nLazyCount, (int)nFullCount);
+		return 1;
+	}
+
+	return 0;
+}
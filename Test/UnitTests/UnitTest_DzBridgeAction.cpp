@@ -110,6 +110,38 @@ bool UnitTest_DzBridgeAction::runUnitTests()
 	RUNTEST(metaInvokeMethod);
 	RUNTEST(copyFile);
 	RUNTEST(getMD5);
+	RUNTEST(getUseMaterialTemplates);
+	RUNTEST(setUseMaterialTemplates);
+	RUNTEST(writeMaterialTemplates);
+	RUNTEST(setMaterialPropertyFilter);
+	RUNTEST(loadMaterialPropertyFilter);
+	RUNTEST(clearMaterialPropertyFilter);
+	RUNTEST(getCompressDtu);
+	RUNTEST(setCompressDtu);
+	RUNTEST(readDtuFile);
+	RUNTEST(writeDtuFile);
+	RUNTEST(getExportMaterialPropertiesBinary);
+	RUNTEST(setExportMaterialPropertiesBinary);
+	RUNTEST(getExportMorphDeltas);
+	RUNTEST(setExportMorphDeltas);
+	RUNTEST(getQuantizeMorphDeltas);
+	RUNTEST(setQuantizeMorphDeltas);
+	RUNTEST(exportMorphDeltas);
+	RUNTEST(getExportGeograftMorphDeltas);
+	RUNTEST(setExportGeograftMorphDeltas);
+	RUNTEST(getUseLegacyObjExporter);
+	RUNTEST(setUseLegacyObjExporter);
+	RUNTEST(getExportMorphBasis);
+	RUNTEST(setExportMorphBasis);
+	RUNTEST(getMorphBasisComponents);
+	RUNTEST(setMorphBasisComponents);
+	RUNTEST(exportMorphBasis);
+	RUNTEST(getJCMLookupTableSize);
+	RUNTEST(setJCMLookupTableSize);
+	RUNTEST(getSparseSubdivisionWeights);
+	RUNTEST(setSparseSubdivisionWeights);
+	RUNTEST(getSubdivisionCacheFolder);
+	RUNTEST(setSubdivisionCacheFolder);
 
 
 	return true;
@@ -841,6 +873,263 @@ bool UnitTest_DzBridgeAction::getMD5(UnitTest::TestResult* testResult)
 	return bResult;
 }
 
+bool UnitTest_DzBridgeAction::getUseMaterialTemplates(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getUseMaterialTemplates());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setUseMaterialTemplates(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setUseMaterialTemplates(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::writeMaterialTemplates(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	DzJsonWriter arg(nullptr);
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->writeMaterialTemplates(arg));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setMaterialPropertyFilter(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setMaterialPropertyFilter("", QStringList(), QStringList()));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::loadMaterialPropertyFilter(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->loadMaterialPropertyFilter(""));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::clearMaterialPropertyFilter(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->clearMaterialPropertyFilter());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getCompressDtu(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getCompressDtu());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setCompressDtu(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setCompressDtu(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::readDtuFile(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->readDtuFile(""));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::writeDtuFile(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->writeDtuFile("", ""));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getExportMaterialPropertiesBinary(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getExportMaterialPropertiesBinary());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setExportMaterialPropertiesBinary(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setExportMaterialPropertiesBinary(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getExportMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getExportMorphDeltas());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setExportMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setExportMorphDeltas(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getQuantizeMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getQuantizeMorphDeltas());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setQuantizeMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setQuantizeMorphDeltas(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::exportMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL_NULLPTR(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->exportMorphDeltas(nullptr, ""));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getExportGeograftMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getExportGeograftMorphDeltas());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setExportGeograftMorphDeltas(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setExportGeograftMorphDeltas(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getUseLegacyObjExporter(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getUseLegacyObjExporter());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setUseLegacyObjExporter(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setUseLegacyObjExporter(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getExportMorphBasis(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getExportMorphBasis());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setExportMorphBasis(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setExportMorphBasis(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getMorphBasisComponents(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getMorphBasisComponents());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setMorphBasisComponents(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setMorphBasisComponents(0));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::exportMorphBasis(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL_NULLPTR(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->exportMorphBasis(nullptr, ""));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getJCMLookupTableSize(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getJCMLookupTableSize());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setJCMLookupTableSize(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setJCMLookupTableSize(0));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getSparseSubdivisionWeights(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getSparseSubdivisionWeights());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setSparseSubdivisionWeights(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setSparseSubdivisionWeights(false));
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::getSubdivisionCacheFolder(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->getSubdivisionCacheFolder());
+
+	return bResult;
+}
+
+bool UnitTest_DzBridgeAction::setSubdivisionCacheFolder(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeNameSpace::DzBridgeAction*>(m_testObject)->setSubdivisionCacheFolder(""));
+
+	return bResult;
+}
+
 
 
 
@@ -95,6 +95,38 @@ private:
 	bool metaInvokeMethod(UnitTest::TestResult* testResult);
 	bool copyFile(UnitTest::TestResult* testResult);
 	bool getMD5(UnitTest::TestResult* testResult);
+	bool getUseMaterialTemplates(UnitTest::TestResult* testResult);
+	bool setUseMaterialTemplates(UnitTest::TestResult* testResult);
+	bool writeMaterialTemplates(UnitTest::TestResult* testResult);
+	bool setMaterialPropertyFilter(UnitTest::TestResult* testResult);
+	bool loadMaterialPropertyFilter(UnitTest::TestResult* testResult);
+	bool clearMaterialPropertyFilter(UnitTest::TestResult* testResult);
+	bool getCompressDtu(UnitTest::TestResult* testResult);
+	bool setCompressDtu(UnitTest::TestResult* testResult);
+	bool readDtuFile(UnitTest::TestResult* testResult);
+	bool writeDtuFile(UnitTest::TestResult* testResult);
+	bool getExportMaterialPropertiesBinary(UnitTest::TestResult* testResult);
+	bool setExportMaterialPropertiesBinary(UnitTest::TestResult* testResult);
+	bool getExportMorphDeltas(UnitTest::TestResult* testResult);
+	bool setExportMorphDeltas(UnitTest::TestResult* testResult);
+	bool getQuantizeMorphDeltas(UnitTest::TestResult* testResult);
+	bool setQuantizeMorphDeltas(UnitTest::TestResult* testResult);
+	bool exportMorphDeltas(UnitTest::TestResult* testResult);
+	bool getExportGeograftMorphDeltas(UnitTest::TestResult* testResult);
+	bool setExportGeograftMorphDeltas(UnitTest::TestResult* testResult);
+	bool getUseLegacyObjExporter(UnitTest::TestResult* testResult);
+	bool setUseLegacyObjExporter(UnitTest::TestResult* testResult);
+	bool getExportMorphBasis(UnitTest::TestResult* testResult);
+	bool setExportMorphBasis(UnitTest::TestResult* testResult);
+	bool getMorphBasisComponents(UnitTest::TestResult* testResult);
+	bool setMorphBasisComponents(UnitTest::TestResult* testResult);
+	bool exportMorphBasis(UnitTest::TestResult* testResult);
+	bool getJCMLookupTableSize(UnitTest::TestResult* testResult);
+	bool setJCMLookupTableSize(UnitTest::TestResult* testResult);
+	bool getSparseSubdivisionWeights(UnitTest::TestResult* testResult);
+	bool setSparseSubdivisionWeights(UnitTest::TestResult* testResult);
+	bool getSubdivisionCacheFolder(UnitTest::TestResult* testResult);
+	bool setSubdivisionCacheFolder(UnitTest::TestResult* testResult);
 
 };
 
@@ -40,6 +40,10 @@ bool UnitTest_DzBridgeMorphSelectionDialog::runUnitTests()
 	RUNTEST(HandleARKitGenesis81MorphsButton);
 	RUNTEST(HandleFaceFXGenesis8Button);
 	RUNTEST(HandleAutoJCMCheckBoxChange);
+	RUNTEST(EnsureMorphCatalogVerified);
+	RUNTEST(GetConnectedMorphsDepthLimit);
+	RUNTEST(SetConnectedMorphsDepthLimit);
+	RUNTEST(InvalidateJointControlledMorphs);
 
 	return true;
 }
@@ -184,5 +188,33 @@ bool UnitTest_DzBridgeMorphSelectionDialog::HandleAutoJCMCheckBoxChange(UnitTest
 	return bResult;
 }
 
+bool UnitTest_DzBridgeMorphSelectionDialog::EnsureMorphCatalogVerified(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeMorphSelectionDialog*>(m_testObject)->EnsureMorphCatalogVerified());
+	return bResult;
+}
+
+bool UnitTest_DzBridgeMorphSelectionDialog::GetConnectedMorphsDepthLimit(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeMorphSelectionDialog*>(m_testObject)->GetConnectedMorphsDepthLimit());
+	return bResult;
+}
+
+bool UnitTest_DzBridgeMorphSelectionDialog::SetConnectedMorphsDepthLimit(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeMorphSelectionDialog*>(m_testObject)->SetConnectedMorphsDepthLimit(0));
+	return bResult;
+}
+
+bool UnitTest_DzBridgeMorphSelectionDialog::InvalidateJointControlledMorphs(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+	TRY_METHODCALL(qobject_cast<DzBridgeMorphSelectionDialog*>(m_testObject)->InvalidateJointControlledMorphs());
+	return bResult;
+}
+
 #include "moc_UnitTest_DzBridgeMorphSelectionDialog.cpp"
 #endif
\ No newline at end of file
@@ -31,6 +31,10 @@ private:
 	bool HandleARKitGenesis81MorphsButton(UnitTest::TestResult* testResult);
 	bool HandleFaceFXGenesis8Button(UnitTest::TestResult* testResult);
 	bool HandleAutoJCMCheckBoxChange(UnitTest::TestResult* testResult);
+	bool EnsureMorphCatalogVerified(UnitTest::TestResult* testResult);
+	bool GetConnectedMorphsDepthLimit(UnitTest::TestResult* testResult);
+	bool SetConnectedMorphsDepthLimit(UnitTest::TestResult* testResult);
+	bool InvalidateJointControlledMorphs(UnitTest::TestResult* testResult);
 
 
 };
@@ -0,0 +1,72 @@
+#ifdef UNITTEST_DZBRIDGE
+
+#include "UnitTest_DzBridgeObjWriter.h"
+#include "DzBridgeObjWriter.h"
+
+#include <limits>
+
+using namespace DzBridgeNameSpace;
+
+UnitTest_DzBridgeObjWriter::UnitTest_DzBridgeObjWriter()
+{
+	m_testObject = nullptr;
+}
+
+bool UnitTest_DzBridgeObjWriter::runUnitTests()
+{
+	RUNTEST(formatFloat);
+
+	return true;
+}
+
+// Compares DzBridgeObjWriter::formatFloat() with qsnprintf("%.*f") for every precision on values that
+// exercise the sign, tie rounding and the C library fallback
+bool UnitTest_DzBridgeObjWriter::formatFloat(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+
+	const float aValues[] = {
+		// zero and negative values that round to zero
+		0.0f, -0.0f, -1e-9f, -4e-7f, -5e-7f, -0.4f, -0.00001f,
+		// exact binary .5 ties at some precision
+		0.5f, 1.5f, 2.5f, -2.5f, 0.125f, -0.375f, 0.0625f, 1.0f / 1024.0f,
+		// ordinary values
+		1.0f, -1.0f, 0.1f, -123.456789f, 65535.99f,
+		// large values, up to and past the integer path
+		9e12f, -9e12f, 1e13f, 1e18f, -1e20f, std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+		// non-finite values
+		std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()
+	};
+	const int nNumValues = sizeof(aValues) / sizeof(aValues[0]);
+
+	int nMismatches = 0;
+	for (int nPrecision = 0; nPrecision <= 8; nPrecision++)
+	{
+		for (int i = 0; i < nNumValues; i++)
+		{
+			char aActual[64];
+			char aExpected[64];
+			char* pEnd = nullptr;
+			TRY_METHODCALL(pEnd = DzBridgeObjWriter::formatFloat(aActual, aValues[i], nPrecision));
+			if (pEnd == nullptr)
+				return false;
+			*pEnd = '\0';
+			qsnprintf(aExpected, sizeof(aExpected), "%.*f", nPrecision, (double)aValues[i]);
+			if (qstrcmp(aActual, aExpected) != 0)
+			{
+				LOGTEST_TEXT(QString("precision %1: got \"%2\", expected \"%3\"").arg(nPrecision).arg(aActual).arg(aExpected));
+				nMismatches++;
+			}
+		}
+	}
+	if (nMismatches > 0)
+	{
+		LOGTEST_FAILED(QString("%1 values differ from printf.").arg(nMismatches));
+		bResult = false;
+	}
+
+	return bResult;
+}
+
+#include "moc_UnitTest_DzBridgeObjWriter.cpp"
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+#ifdef UNITTEST_DZBRIDGE
+
+#include <QObject>
+#include "UnitTest.h"
+
+class UnitTest_DzBridgeObjWriter : public UnitTest {
+	Q_OBJECT
+public:
+	UnitTest_DzBridgeObjWriter();
+	bool runUnitTests();
+
+private:
+	bool formatFloat(UnitTest::TestResult* testResult);
+
+};
+
+
+#endif
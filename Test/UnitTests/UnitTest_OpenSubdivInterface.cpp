@@ -0,0 +1,126 @@
+#ifdef UNITTEST_DZBRIDGE
+
+#include "UnitTest_OpenSubdivInterface.h"
+#include "OpenSubdivInterface.h"
+
+#include <cmath>
+#include <vector>
+#include <opensubdiv/far/topologyDescriptor.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+
+namespace
+{
+	// primvar for Far::StencilTable::UpdateValues()
+	struct Vertex
+	{
+		float Position[3];
+		void Clear() { Position[0] = Position[1] = Position[2] = 0.0f; }
+		void AddWithWeight(const Vertex& src, float weight)
+		{
+			Position[0] += weight * src.Position[0];
+			Position[1] += weight * src.Position[1];
+			Position[2] += weight * src.Position[2];
+		}
+	};
+}
+
+UnitTest_OpenSubdivInterface::UnitTest_OpenSubdivInterface()
+{
+	m_testObject = nullptr;
+}
+
+bool UnitTest_OpenSubdivInterface::runUnitTests()
+{
+	RUNTEST(SubdivisionTopology_Refine);
+
+	return true;
+}
+
+// Refines a cube to level 5 (6146 vertices, more than one block of stencils) with SubdivisionTopology::Refine()
+// and compares every vertex against Far::StencilTable::UpdateValues()
+bool UnitTest_OpenSubdivInterface::SubdivisionTopology_Refine(UnitTest::TestResult* testResult)
+{
+	bool bResult = true;
+
+	const int nSubDLevel = 5;
+	const float aCubePositions[8 * 3] = {
+		-0.5f, -0.5f,  0.5f,   0.5f, -0.5f,  0.5f,  -0.5f,  0.5f,  0.5f,   0.5f,  0.5f,  0.5f,
+		-0.5f,  0.5f, -0.5f,   0.5f,  0.5f, -0.5f,  -0.5f, -0.5f, -0.5f,   0.5f, -0.5f, -0.5f };
+	const int aCubeVertsPerFace[6] = { 4, 4, 4, 4, 4, 4 };
+	const int aCubeFaceVerts[24] = { 0, 1, 3, 2,  2, 3, 5, 4,  4, 5, 7, 6,  6, 7, 1, 0,  1, 7, 5, 3,  6, 0, 2, 4 };
+
+	typedef OpenSubdiv::Far::TopologyDescriptor Descriptor;
+	OpenSubdiv::Sdc::Options options;
+	options.SetVtxBoundaryInterpolation(OpenSubdiv::Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+	Descriptor desc;
+	desc.numVertices = 8;
+	desc.numFaces = 6;
+	desc.numVertsPerFace = aCubeVertsPerFace;
+	desc.vertIndicesPerFace = aCubeFaceVerts;
+	OpenSubdiv::Far::TopologyRefiner* refiner = OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Create(desc,
+		OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Options(OpenSubdiv::Sdc::SCHEME_CATMARK, options));
+	if (refiner == nullptr)
+	{
+		LOGTEST_FAILED("Unable to create the topology refiner.");
+		return false;
+	}
+	refiner->RefineUniform(OpenSubdiv::Far::TopologyRefiner::UniformOptions(nSubDLevel));
+
+	OpenSubdiv::Far::StencilTableFactory::Options stencilOptions;
+	stencilOptions.generateIntermediateLevels = false;
+	stencilOptions.generateOffsets = true;
+	OpenSubdiv::Far::StencilTable const* stencilTable = OpenSubdiv::Far::StencilTableFactory::Create(*refiner, stencilOptions);
+	delete refiner;
+
+	SubdivisionTopology topology;
+	topology.SubDLevel = nSubDLevel;
+	topology.NumCoarseVerts = 8;
+	topology.NumFineVerts = stencilTable->GetNumStencils();
+	topology.StencilSizes = stencilTable->GetSizes();
+	topology.StencilOffsets = stencilTable->GetOffsets();
+	topology.StencilIndices = stencilTable->GetControlIndices();
+	topology.StencilWeights = stencilTable->GetWeights();
+
+	std::vector<Vertex> aCoarse(8);
+	for (int i = 0; i < 8; i++)
+	{
+		aCoarse[i].Position[0] = aCubePositions[i * 3 + 0];
+		aCoarse[i].Position[1] = aCubePositions[i * 3 + 1];
+		aCoarse[i].Position[2] = aCubePositions[i * 3 + 2];
+	}
+	std::vector<Vertex> aExpected(topology.NumFineVerts);
+	stencilTable->UpdateValues(aCoarse.data(), aExpected.data());
+	delete stencilTable;
+
+	if (topology.NumFineVerts <= 4096)
+	{
+		LOGTEST_FAILED(QString("Expected more than 4096 fine vertices, got %1.").arg(topology.NumFineVerts));
+		return false;
+	}
+
+	std::vector<float> aFine(topology.NumFineVerts * 3, 0.0f);
+	TRY_METHODCALL(topology.Refine(aCubePositions, aFine.data(), 3));
+
+	int nMismatches = 0;
+	for (int i = 0; i < topology.NumFineVerts; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			if (fabs(aFine[i * 3 + c] - aExpected[i].Position[c]) > 1e-5f)
+			{
+				nMismatches++;
+				break;
+			}
+		}
+	}
+	if (nMismatches > 0)
+	{
+		LOGTEST_FAILED(QString("%1 of %2 refined vertices differ from Far::StencilTable::UpdateValues().").arg(nMismatches).arg(topology.NumFineVerts));
+		bResult = false;
+	}
+
+	return bResult;
+}
+
+#include "moc_UnitTest_OpenSubdivInterface.cpp"
+#endif
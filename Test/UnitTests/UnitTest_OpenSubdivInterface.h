@@ -0,0 +1,19 @@
+#pragma once
+#ifdef UNITTEST_DZBRIDGE
+
+#include <QObject>
+#include "UnitTest.h"
+
+class UnitTest_OpenSubdivInterface : public UnitTest {
+	Q_OBJECT
+public:
+	UnitTest_OpenSubdivInterface();
+	bool runUnitTests();
+
+private:
+	bool SubdivisionTopology_Refine(UnitTest::TestResult* testResult);
+
+};
+
+
+#endif
@@ -7,14 +7,22 @@
 #include <dzweightmap.h>
 #include "QtCore/qfile.h"
 #include "QtCore/qtextstream.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qset.h"
 
 #include "DzBridgeMorphSelectionDialog.h"
+#include "DzBridgeMaterialPropertyTable.h"
+#include "DzBridgeMorphLinkGraph.h"
+#include "DzBridgeMorphDeltaWriter.h"
+#include "DzBridgeObjWriter.h"
+#include "DzBridgeMorphBasisWriter.h"
 
 #include <fbxsdk.h>
 
 class DzProgress;
 class DzGeometry;
 class DzFigure;
+class DzMorph;
 
 class UnitTest_DzBridgeAction;
 
@@ -55,6 +63,18 @@ namespace DzBridgeNameSpace
 		Q_PROPERTY(DzBasicDialog* wBridgeDialog READ getBridgeDialog WRITE setBridgeDialog)
 		Q_PROPERTY(DzBasicDialog* wSubdivisionDialog READ getSubdivisionDialog WRITE setSubdivisionDialog)
 		Q_PROPERTY(DzBasicDialog* wMorphSelectionDialog READ getMorphSelectionDialog WRITE setMorphSelectionDialog)
+		Q_PROPERTY(bool bUseMaterialTemplates READ getUseMaterialTemplates WRITE setUseMaterialTemplates)
+		Q_PROPERTY(bool bCompressDtu READ getCompressDtu WRITE setCompressDtu)
+		Q_PROPERTY(bool bExportMaterialPropertiesBinary READ getExportMaterialPropertiesBinary WRITE setExportMaterialPropertiesBinary)
+		Q_PROPERTY(bool bExportMorphDeltas READ getExportMorphDeltas WRITE setExportMorphDeltas)
+		Q_PROPERTY(bool bQuantizeMorphDeltas READ getQuantizeMorphDeltas WRITE setQuantizeMorphDeltas)
+		Q_PROPERTY(bool bExportGeograftMorphDeltas READ getExportGeograftMorphDeltas WRITE setExportGeograftMorphDeltas)
+		Q_PROPERTY(bool bUseLegacyObjExporter READ getUseLegacyObjExporter WRITE setUseLegacyObjExporter)
+		Q_PROPERTY(bool bExportMorphBasis READ getExportMorphBasis WRITE setExportMorphBasis)
+		Q_PROPERTY(int nMorphBasisComponents READ getMorphBasisComponents WRITE setMorphBasisComponents)
+		Q_PROPERTY(int nJCMLookupTableSize READ getJCMLookupTableSize WRITE setJCMLookupTableSize)
+		Q_PROPERTY(bool bSparseSubdivisionWeights READ getSparseSubdivisionWeights WRITE setSparseSubdivisionWeights)
+		Q_PROPERTY(QString sSubdivisionCacheFolder READ getSubdivisionCacheFolder WRITE setSubdivisionCacheFolder)
 
 	public:
 
@@ -82,6 +102,8 @@ namespace DzBridgeNameSpace
 
 		Q_INVOKABLE static bool copyFile(QFile* file, QString* dst, bool replace = true, bool compareFiles = true);
 		Q_INVOKABLE static QString getMD5(const QString& path);
+		Q_INVOKABLE static QString readDtuFile(QString sDtuFilename);
+		Q_INVOKABLE static bool writeDtuFile(QString sDtuFilename, QString sContents, bool bCompress = false);
 
 	protected:
 		// Struct to remember attachment info
@@ -91,6 +113,23 @@ namespace DzBridgeNameSpace
 			DzNode* Child;
 		};
 
+		// Allow and Deny lists of material property names for one shader type
+		struct MaterialPropertyFilter
+		{
+			QSet<QString> aAllowList;
+			QSet<QString> aDenyList;
+		};
+
+		// Default value of a material property, shared by all materials of one shader type
+		struct MaterialTemplateProperty
+		{
+			QString sLabel;
+			QString sType;
+			QString sValue;
+			double dValue;
+			bool bUseNumeric;
+		};
+
 		DzBridgeDialog* m_bridgeDialog;
 		DzBridgeSubdivisionDialog* m_subdivisionDialog;
 		DzBridgeMorphSelectionDialog* m_morphSelectionDialog;
@@ -114,17 +153,43 @@ namespace DzBridgeNameSpace
 		QString m_sProductComponentName; // Friendly name of Component of Daz Store Product, can contain spaces and special characters
 		QStringList m_aMorphListOverride; // overrides Morph Selection Dialog
 		bool m_bUseRelativePaths; // use relative paths in DTU instead of absolute paths
+		bool m_bCompressDtu; // write DTU file as a compressed zip archive
 		bool m_bGenerateNormalMaps; // generate normal maps from height maps
 		bool m_bUndoNormalMaps;  // remove generated normal maps after export
 		QString m_sExportFbx; // override filename of exported fbx
 
 		bool m_bEnableMorphs; // enable morph export
+		bool m_bExportMorphDeltas; // write sparse morph deltas read from DzMorph: <m_sAssetName>_MorphDeltas.bytes
+		bool m_bQuantizeMorphDeltas; // store morph deltas as 16-bit integers with a per-morph scale
+		bool m_bExportMorphBasis; // write a PCA basis of the exported morphs: <m_sAssetName>_MorphBasis.bytes
+		int m_nMorphBasisComponents; // maximum PCA components per mesh, 0 = as many as needed for 99.9% of the delta energy
+		int m_nJCMLookupTableSize; // samples per keyed ERC curve in "Lookup Table" arrays of the DTU, 0 = keys only
+		bool m_bExportGeograftMorphDeltas; // write all geograft morphs to <m_sAssetName>_GeograftMorphs.bytes instead of one OBJ per morph
+		bool m_bUseLegacyObjExporter; // exportObj() goes through DzObjExporter instead of DzBridgeObjWriter
 		bool m_EnableSubdivisions; // enable subdivision baking
+		bool m_bSparseSubdivisionWeights; // upgradeToHD() refines each skin cluster only over its influence region
+		QString m_sSubdivisionCacheFolder; // refined topologies reused across exports by upgradeToHD(), empty = no disk cache (default)
 		bool m_bExportingBaseMesh;
 		bool m_bShowFbxOptions;
 		bool m_bExportMaterialPropertiesCSV;
+		bool m_bExportMaterialPropertiesBinary; // write material properties as binary columnar table: <m_sAssetName>_Maps.bytes
+		DzBridgeMaterialPropertyTable m_MaterialPropertyTable; // material property rows collected by writeAllMaterials()
+		DzBridgeMorphLinkGraph m_MorphLinkGraph; // ERC links of the exported morphs, built by writeMorphLinks()
+		DzNode* m_pControlledMeshIndexNode; // node the controlled mesh index was built for, nullptr when not built
+		QHash<QString, QStringList> m_mBoneToControlledMeshes; // bone name -> child meshes with a bone binding for it
+		QHash<QString, QStringList> m_mMorphToControlledMeshes; // modifier name -> child meshes with that modifier
 		DzNode* m_pSelectedNode;
 
+		// Material Templates: write default property values once per shader type and
+		// only the non-default or textured properties in each material block
+		bool m_bUseMaterialTemplates;
+		QMap<QString, QMap<QString, MaterialTemplateProperty>> m_mMaterialTemplates; // Shader Type -> Property Name -> Default Value
+		int m_nMaterialPropertiesWritten;
+		int m_nMaterialPropertiesOmitted;
+
+		// Material Property Filter: Shader Type -> Allow/Deny lists, "*" applies to all shader types
+		QHash<QString, MaterialPropertyFilter> m_mMaterialPropertyFilter;
+
 		// Animation Settings
 		bool m_bAnimationUseExperimentalTransfer;
 		bool m_bAnimationBake;
@@ -144,16 +209,20 @@ namespace DzBridgeNameSpace
 		virtual void setExportOptions(DzFileIOSettings& ExportOptions) = 0;
 		virtual QString readGuiRootFolder() = 0;
 
+		// Opens the DTU file for writing, compressed if m_bCompressDtu is set. Caller must close and delete.
+		QIODevice* openDtuFile(QString sDtuFilename);
 		Q_INVOKABLE virtual void writeDTUHeader(DzJsonWriter& writer);
 
 		Q_INVOKABLE virtual void writeAllMaterials(DzNode* Node, DzJsonWriter& Writer, QTextStream* CVSStream = nullptr, bool bRecursive = false);
 		Q_INVOKABLE virtual void startMaterialBlock(DzNode* Node, DzJsonWriter& Writer, QTextStream* pCVSStream, DzMaterial* Material);
 		Q_INVOKABLE virtual void finishMaterialBlock(DzJsonWriter& Writer);
 		Q_INVOKABLE virtual void writeMaterialProperty(DzNode* Node, DzJsonWriter& Writer, QTextStream* pCVSStream, DzMaterial* Material, DzProperty* Property);
+		Q_INVOKABLE virtual void writeMaterialTemplates(DzJsonWriter& Writer);
 
 		Q_INVOKABLE virtual void writeAllMorphs(DzJsonWriter& Writer);
 		Q_INVOKABLE virtual void writeMorphProperties(DzJsonWriter& writer, const QString& key, const QString& value);
 		Q_INVOKABLE virtual void writeMorphJointLinkInfo(DzJsonWriter& writer, const JointLinkInfo& linkInfo);
+		void writeKeyCurveLookupTable(DzJsonWriter& writer, const QVector<double>& aKeys, const QVector<double>& aKeyValues, int nKeyInterpolation, double fMin, double fMax);
 
 		Q_INVOKABLE virtual void writeAllSubdivisions(DzJsonWriter& Writer);
 		Q_INVOKABLE virtual void writeSubdivisionProperties(DzJsonWriter& writer, const QString& Name, int targetValue);
@@ -183,6 +252,7 @@ namespace DzBridgeNameSpace
 
 		// For Pose exports check if writing to the timeline will alter existing keys
 		bool checkIfPoseExportIsDestructive();
+		QList<QPair<QString, DzNumericProperty*>> getPoseMorphProperties(DzNode* Selection);
 
 		// Need to be able to move asset instances to origin during environment export
 		void unlockTranform(DzNode* NodeToUnlock);
@@ -216,11 +286,53 @@ namespace DzBridgeNameSpace
 		Q_INVOKABLE bool getUseRelativePaths() { return this->m_bUseRelativePaths; };
 		Q_INVOKABLE void setUseRelativePaths(bool arg_UseRelativePaths) { this->m_bUseRelativePaths = arg_UseRelativePaths; };
 
+		Q_INVOKABLE void setMaterialPropertyFilter(QString sShaderType, QStringList aAllowList, QStringList aDenyList);
+		Q_INVOKABLE bool loadMaterialPropertyFilter(QString sFilterFilePath);
+		Q_INVOKABLE void clearMaterialPropertyFilter() { this->m_mMaterialPropertyFilter.clear(); };
+
+		Q_INVOKABLE bool getExportMaterialPropertiesBinary() { return this->m_bExportMaterialPropertiesBinary; };
+		Q_INVOKABLE void setExportMaterialPropertiesBinary(bool arg_ExportBinary) { this->m_bExportMaterialPropertiesBinary = arg_ExportBinary; };
+
+		Q_INVOKABLE bool getExportMorphDeltas() { return this->m_bExportMorphDeltas; };
+		Q_INVOKABLE void setExportMorphDeltas(bool arg_ExportMorphDeltas) { this->m_bExportMorphDeltas = arg_ExportMorphDeltas; };
+
+		Q_INVOKABLE bool getQuantizeMorphDeltas() { return this->m_bQuantizeMorphDeltas; };
+		Q_INVOKABLE void setQuantizeMorphDeltas(bool arg_QuantizeMorphDeltas) { this->m_bQuantizeMorphDeltas = arg_QuantizeMorphDeltas; };
+
+		Q_INVOKABLE bool getExportMorphBasis() { return this->m_bExportMorphBasis; };
+		Q_INVOKABLE void setExportMorphBasis(bool arg_ExportMorphBasis) { this->m_bExportMorphBasis = arg_ExportMorphBasis; };
+
+		Q_INVOKABLE int getMorphBasisComponents() { return this->m_nMorphBasisComponents; };
+		Q_INVOKABLE void setMorphBasisComponents(int arg_MorphBasisComponents) { this->m_nMorphBasisComponents = arg_MorphBasisComponents; };
+
+		Q_INVOKABLE int getJCMLookupTableSize() { return this->m_nJCMLookupTableSize; };
+		Q_INVOKABLE void setJCMLookupTableSize(int arg_JCMLookupTableSize) { this->m_nJCMLookupTableSize = arg_JCMLookupTableSize; };
+
+		Q_INVOKABLE bool getSparseSubdivisionWeights() { return this->m_bSparseSubdivisionWeights; };
+		Q_INVOKABLE void setSparseSubdivisionWeights(bool arg_SparseSubdivisionWeights) { this->m_bSparseSubdivisionWeights = arg_SparseSubdivisionWeights; };
+
+		Q_INVOKABLE QString getSubdivisionCacheFolder() { return this->m_sSubdivisionCacheFolder; };
+		Q_INVOKABLE void setSubdivisionCacheFolder(QString arg_SubdivisionCacheFolder) { this->m_sSubdivisionCacheFolder = arg_SubdivisionCacheFolder; };
+
+		Q_INVOKABLE bool getExportGeograftMorphDeltas() { return this->m_bExportGeograftMorphDeltas; };
+		Q_INVOKABLE void setExportGeograftMorphDeltas(bool arg_ExportGeograftMorphDeltas) { this->m_bExportGeograftMorphDeltas = arg_ExportGeograftMorphDeltas; };
+
+		Q_INVOKABLE bool getUseLegacyObjExporter() { return this->m_bUseLegacyObjExporter; };
+		Q_INVOKABLE void setUseLegacyObjExporter(bool arg_UseLegacyObjExporter) { this->m_bUseLegacyObjExporter = arg_UseLegacyObjExporter; };
+
+		Q_INVOKABLE bool getCompressDtu() { return this->m_bCompressDtu; };
+		Q_INVOKABLE void setCompressDtu(bool arg_CompressDtu) { this->m_bCompressDtu = arg_CompressDtu; };
+
+		Q_INVOKABLE bool getUseMaterialTemplates() { return this->m_bUseMaterialTemplates; };
+		Q_INVOKABLE void setUseMaterialTemplates(bool arg_UseMaterialTemplates) { this->m_bUseMaterialTemplates = arg_UseMaterialTemplates; };
+
 		bool isTemporaryFile(QString sFilename);
 		QString exportAssetWithDtu(QString sFilename, QString sAssetMaterialName = "");
 		void writePropertyTexture(DzJsonWriter& Writer, QString sName, QString sLabel, QString sValue, QString sType, QString sTexture);
 		void writePropertyTexture(DzJsonWriter& Writer, QString sName, QString sLabel, double dValue, QString sType, QString sTexture);
 		QString makeUniqueFilename(QString sFilename);
+		bool isMaterialPropertyFiltered(DzMaterial* Material, DzProperty* Property);
+		bool isMaterialTemplateDefault(DzMaterial* Material, DzProperty* Property, QString sLabel, QString sType, QString sValue, double dValue, bool bUseNumeric);
 
 		Q_INVOKABLE bool getGenerateNormalMaps() { return this->m_bGenerateNormalMaps; };
 		Q_INVOKABLE void setGenerateNormalMaps(bool arg_GenerateNormalMaps) { this->m_bGenerateNormalMaps = arg_GenerateNormalMaps; };
@@ -249,10 +361,20 @@ namespace DzBridgeNameSpace
 
 		Q_INVOKABLE virtual void writeMorphLinks(DzJsonWriter& writer);
 		Q_INVOKABLE virtual void writeMorphNames(DzJsonWriter& writer);
+		Q_INVOKABLE virtual void writeMorphDeltas(DzJsonWriter& writer);
+		Q_INVOKABLE bool exportMorphDeltas(DzNode* Node, QString sFilename);
+		Q_INVOKABLE virtual void writeMorphBasis(DzJsonWriter& writer);
+		Q_INVOKABLE bool exportMorphBasis(DzNode* Node, QString sFilename);
+		Q_INVOKABLE virtual void writeGeograftMorphs(DzJsonWriter& writer);
+		DzNodeList getMorphDeltaMeshNodes(DzNode* Node);
+		bool readMorphDeltas(DzMorph* pMorph, QVector<qint32>& aIndices, QVector<float>& aDeltas);
 		Q_INVOKABLE QStringList checkMorphControlsChildren(DzNode* pNode, DzProperty* pProperty);
 		Q_INVOKABLE QStringList checkForBoneInChild(DzNode* pNode, QString sBoneName, QStringList& controlledMeshList);
 		Q_INVOKABLE QStringList checkForBoneInAlias(DzNode* pNode, DzProperty* pMorphProperty, QStringList& controlledMeshList);
 		Q_INVOKABLE QStringList checkForMorphOnChild(DzNode* pNode, QString sBoneName, QStringList& controlledMeshList);
+		// Index child figure meshes by skinned bone name and by modifier name, used by the checkFor...() methods above
+		void buildControlledMeshIndex(DzNode* pNode);
+		void clearControlledMeshIndex();
 
 		Q_INVOKABLE DzNodeList buildRootNodeList();
 		Q_INVOKABLE DzNodeList findRootNodes(DzNode* pNode);
@@ -261,8 +383,12 @@ namespace DzBridgeNameSpace
 		virtual void resetArray_ControllersToDisconnect();
 		Q_INVOKABLE bool checkForIrreversibleOperations_in_disconnectOverrideControllers();
 		Q_INVOKABLE bool exportObj(QString filepath);
+		Q_INVOKABLE bool exportObjWithDzObjExporter(QString filepath);
 		Q_INVOKABLE bool exportGeograftMorphs(DzNode *Node, QString destinationFolder);
 		Q_INVOKABLE bool checkForGeograftMorphsToExport(DzNode* Node, bool bZeroMorphForExport=false);
+		bool exportGeograftMorphsAsObj(DzNode* pParentNode, DzNode* pGeograftNode, const QList<QPair<QString, DzNumericProperty*>>& aGeograftMorphs, QString sDestinationFolder);
+		int readCachedVertexPositions(DzNode* pNode, QVector<float>& aPositions);
+		DzNode* findGeograftNode(DzNode* Node);
 
 	private:
 		class MaterialGroupExportOrderMetaData
@@ -0,0 +1,68 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qtextstream.h>
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// Column-oriented buffer of material property rows for the material property CSV.
+	/// Rows are collected during writeAllMaterials() and written in large blocks afterwards,
+	/// either as CSV text or as a compact binary table.  Repeated strings (object, material,
+	/// shader, property names, etc) are stored once in a string table and referenced by index.
+	///
+	/// Binary format (little endian):
+	///   char[4] "DZMP", uint32 version, uint32 row count
+	///   uint32 string count, then for each string: uint32 byte length, UTF-8 bytes
+	///   uint32 column count, then for each column: uint32 name length, UTF-8 name, uint8 column type
+	///   column data, one column after another: int32 (type 0), uint32 string index (type 1, 0xFFFFFFFF = none),
+	///   float64 (type 2)
+	/// </summary>
+	class CPP_Export DzBridgeMaterialPropertyTable {
+	public:
+		DzBridgeMaterialPropertyTable();
+
+		void clear();
+		int getRowCount() const { return m_aVersion.count(); }
+
+		void addRow(int nVersion, const QString& sObject, const QString& sMaterial, const QString& sShader,
+			const QString& sProperty, const QString& sValue, const QString& sDataType, const QString& sTexture);
+		void addRow(int nVersion, const QString& sObject, const QString& sMaterial, const QString& sShader,
+			const QString& sProperty, double dValue, const QString& sDataType, const QString& sTexture);
+
+		// Writes all rows as CSV lines, in blocks of nBlockRows rows per stream write
+		void writeCSV(QTextStream& stream, int nBlockRows = 4096) const;
+		// Writes all rows in the binary columnar format
+		bool writeBinary(const QString& sFilename) const;
+
+	private:
+		enum ColumnType
+		{
+			ColumnType_Int32 = 0,
+			ColumnType_String = 1,
+			ColumnType_Double = 2
+		};
+		static const quint32 s_nNoString = 0xFFFFFFFF;
+
+		quint32 getStringIndex(const QString& sValue);
+		void addKeyColumns(int nVersion, const QString& sObject, const QString& sMaterial, const QString& sShader,
+			const QString& sProperty, const QString& sDataType, const QString& sTexture);
+
+		QStringList m_aStrings;
+		QHash<QString, quint32> m_mStringIndex;
+
+		QVector<qint32> m_aVersion;
+		QVector<quint32> m_aObject;
+		QVector<quint32> m_aMaterial;
+		QVector<quint32> m_aShader;
+		QVector<quint32> m_aProperty;
+		QVector<quint32> m_aStringValue;
+		QVector<double> m_aNumericValue;
+		QVector<quint32> m_aDataType;
+		QVector<quint32> m_aTexture;
+	};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qlist.h>
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// Compresses the morphs of each mesh into a truncated PCA basis and writes it to a binary sidecar file.
+	/// Morph deltas are added sparse (as for DzBridgeMorphDeltaWriter); per mesh they are expanded over the
+	/// union of moved vertices.  The basis comes from the eigen decomposition of the morph Gram matrix
+	/// (equivalent to an SVD of the delta matrix, since there are far fewer morphs than vertices): the Gram
+	/// matrix and the basis vectors are computed in parallel (QtConcurrent), the eigen solver is cyclic Jacobi.
+	/// Deltas are not mean-centered, so a morph at weight 0 stays the rest shape.
+	///
+	/// Each morph is reconstructed as  delta = sum_k Coefficients[k] * Basis[k].  The number of components is
+	/// the smallest that keeps fEnergyKept of the total squared delta magnitude, limited to nMaxComponents
+	/// (0 = no limit).
+	///
+	/// Binary format (little endian):
+	///   char[4] "DZMB", uint32 version, uint32 mesh count
+	///   for each mesh:
+	///     uint32 byte length + UTF-8 mesh name, uint32 mesh vertex count
+	///     uint32 basis vertex count N, int32[N] vertex indices (ascending)
+	///     uint32 component count K, float32[K] component variance (eigenvalue)
+	///     float32[K][N * 3] orthonormal basis vectors
+	///     uint32 morph count, for each morph:
+	///       uint32 byte length + UTF-8 morph name, float32[K] coefficients,
+	///       float32 RMS reconstruction error per basis vertex, float32 relative reconstruction error
+	/// </summary>
+	class CPP_Export DzBridgeMorphBasisWriter {
+	public:
+		DzBridgeMorphBasisWriter(int nMaxComponents = 0, float fEnergyKept = 0.999f);
+
+		void clear();
+		int getNumMorphs() const { return m_aMorphs.count(); }
+
+		// aDeltas holds 3 floats per entry of aIndices
+		void addMorph(const QString& sMeshName, const QString& sMorphName, int nVertexCount,
+			const QVector<qint32>& aIndices, const QVector<float>& aDeltas);
+
+		// Computes the basis of each mesh and writes the sidecar file
+		bool write(const QString& sFilename);
+
+		// Filled by write(): components kept per mesh, and the largest relative error of any morph
+		int getNumComponents(const QString& sMeshName) const;
+		float getMaxRelativeError() const { return m_fMaxRelativeError; }
+
+		// Eigen decomposition of the symmetric n x n row-major matrix pMatrix (destroyed).
+		// pEigenvalues gets n values, pEigenvectors the n x n row-major matrix with eigenvector i in column i.
+		static void jacobiEigen(double* pMatrix, int n, double* pEigenvalues, double* pEigenvectors);
+
+	private:
+		struct MorphRecord
+		{
+			QString MeshName;
+			QString MorphName;
+			qint32 VertexCount;
+			QVector<qint32> Indices;
+			QVector<float> Deltas;
+		};
+
+		struct MeshBasis
+		{
+			QString MeshName;
+			qint32 VertexCount;
+			QVector<qint32> Vertices;
+			QVector<float> Variance;
+			QVector<float> Basis;
+			QStringList MorphNames;
+			QVector<float> Coefficients;
+			QVector<float> RMSError;
+			QVector<float> RelativeError;
+		};
+
+		void computeMeshBasis(MeshBasis& meshBasis, const QList<int>& aMorphIndices) const;
+
+		int m_nMaxComponents;
+		float m_fEnergyKept;
+		float m_fMaxRelativeError;
+		QList<MorphRecord> m_aMorphs;
+		QList<MeshBasis> m_aMeshes;
+	};
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qlist.h>
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// Collects sparse per-vertex morph deltas and writes them to a binary sidecar file.
+	/// Vertex indices refer to the base mesh vertex order of the named mesh.  Deltas smaller than
+	/// the threshold are dropped, and can optionally be quantized to 16 bits per component with a
+	/// per-morph scale.  Filtering and quantization run in parallel over the morphs (QtConcurrent);
+	/// addMorph() itself only copies data and is called from the main thread.
+	///
+	/// Binary format (little endian):
+	///   char[4] "DZMD", uint32 version, uint32 flags (bit 0 = quantized), uint32 morph count
+	///   for each morph:
+	///     uint32 byte length + UTF-8 mesh name, uint32 byte length + UTF-8 morph name
+	///     uint32 mesh vertex count, uint32 delta count, float32 scale
+	///     int32[delta count] vertex indices (ascending)
+	///     quantized: int16[delta count * 3] (delta = value * scale), else float32[delta count * 3]
+	/// </summary>
+	class CPP_Export DzBridgeMorphDeltaWriter {
+	public:
+		DzBridgeMorphDeltaWriter(bool bQuantize = false, float fThreshold = 1e-5f);
+
+		void clear();
+		int getNumMorphs() const { return m_aMorphs.count(); }
+		bool getQuantize() const { return m_bQuantize; }
+
+		// aDeltas holds 3 floats per entry of aIndices
+		void addMorph(const QString& sMeshName, const QString& sMorphName, int nVertexCount,
+			const QVector<qint32>& aIndices, const QVector<float>& aDeltas);
+
+		// Filters and quantizes all morphs (in parallel) and writes the sidecar file
+		bool write(const QString& sFilename);
+
+	private:
+		struct MorphRecord
+		{
+			QString MeshName;
+			QString MorphName;
+			qint32 VertexCount;
+			QVector<qint32> Indices;
+			QVector<float> Deltas;
+			// filled by encodeMorph()
+			float Scale;
+			QVector<qint16> QuantizedDeltas;
+		};
+		static void encodeMorph(MorphRecord& record, bool bQuantize, float fThreshold);
+
+		bool m_bQuantize;
+		float m_fThreshold;
+		QList<MorphRecord> m_aMorphs;
+	};
+
+}
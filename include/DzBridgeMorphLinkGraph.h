@@ -0,0 +1,104 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtCore/qlist.h>
+
+#include "dzbridge.h"
+
+class DzProperty;
+class DzController;
+class DzERCLink;
+
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// One controller connection between two properties.
+	/// ControllerProperty drives SlaveProperty.  ERCLink is nullptr for non-ERC controllers
+	/// (these are only collected from slave controller lists, where the driver is known).
+	/// Names are precomputed: ControllerBone/SlaveBone are "None" when the owner is not a bone,
+	/// ControllerName/SlaveName use the morph name when the property is owned by a DzMorph.
+	/// </summary>
+	struct MorphLinkEdge
+	{
+		DzProperty* ControllerProperty;
+		DzProperty* SlaveProperty;
+		DzController* Controller;
+		DzERCLink* ERCLink;
+		int Type;
+		double Scalar;
+		double Addend;
+		int KeyInterpolation;
+		QVector<double> Keys;
+		QVector<double> KeyValues;
+		QString ControllerBone;
+		QString ControllerName;
+		QString SlaveBone;
+		QString SlaveName;
+
+		MorphLinkEdge()
+		{
+			ControllerProperty = nullptr;
+			SlaveProperty = nullptr;
+			Controller = nullptr;
+			ERCLink = nullptr;
+			Type = -1;
+			Scalar = 0.0;
+			Addend = 0.0;
+			KeyInterpolation = 0;
+		}
+	};
+
+	/// <summary>
+	/// Morph dependency graph built from the ERC controller lists of morph properties.
+	/// Each property's controllerListIterator() and slaveControllerListIterator() are walked once,
+	/// edges are shared between both ends, and all later morph link, disconnect and connected-morph
+	/// queries read from the graph.  Properties that were not added up front are added on first query.
+	/// Call clear() whenever the scene may have changed, since the graph stores raw property pointers.
+	/// </summary>
+	class CPP_Export DzBridgeMorphLinkGraph {
+	public:
+		DzBridgeMorphLinkGraph() {}
+
+		void clear();
+		void addProperty(DzProperty* pProperty);
+		void addProperties(const QList<DzProperty*>& aProperties);
+		bool containsProperty(DzProperty* pProperty) const { return m_aVisited.contains(pProperty); }
+
+		int getNumEdges() const { return m_aEdges.count(); }
+		const MorphLinkEdge& getEdge(int nIndex) const { return m_aEdges[nIndex]; }
+
+		// Edges driving pProperty, in controllerListIterator() order (ERC links only)
+		QVector<int> getControllerEdges(DzProperty* pProperty);
+		// Edges driven by pProperty, in slaveControllerListIterator() order
+		QVector<int> getSlaveEdges(DzProperty* pProperty);
+
+		// Returns the morph name for morph-owned properties, otherwise the property name
+		// (DzBridgeMorphSelectionDialog::getMorphPropertyName, "" for nullptr)
+		static QString getPropertyName(DzProperty* pProperty);
+		// Returns the owning bone name, or "None"
+		static QString getBoneName(DzProperty* pProperty);
+
+		// Samples a keyed (Type 6) ERC curve at nSize evenly spaced inputs from fMin to fMax inclusive,
+		// so that aTable[i] is the key curve at fMin + i * (fMax - fMin) / (nSize - 1).
+		// nKeyInterpolation 0 is linear, anything else is evaluated as a cubic Hermite spline with
+		// Catmull-Rom tangents (TCB with zero tension, continuity and bias).  The curve is held at the
+		// first and last key values outside the keyed range.  Returns false if there are no keys.
+		static bool sampleKeyCurve(const QVector<double>& aKeys, const QVector<double>& aKeyValues, int nKeyInterpolation,
+			double fMin, double fMax, int nSize, QVector<float>& aTable);
+		// Input range for sampleKeyCurve(): the limits of the controller property when it is clamped
+		// (for bone rotations these are the limits written by DzBridgeAction::writeLimitData), otherwise the keyed range.
+		static bool getKeyCurveRange(DzProperty* pControllerProperty, const QVector<double>& aKeys, double& fMin, double& fMax);
+
+	private:
+		int findOrAddEdge(DzController* pController, DzProperty* pControllerProperty);
+
+		QVector<MorphLinkEdge> m_aEdges;
+		QHash<DzController*, int> m_mControllerToEdge;
+		QHash<DzProperty*, QVector<int>> m_mControllerEdges;
+		QHash<DzProperty*, QVector<int>> m_mSlaveEdges;
+		QSet<DzProperty*> m_aVisited;
+	};
+
+}
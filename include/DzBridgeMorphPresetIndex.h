@@ -0,0 +1,57 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qdatetime.h>
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// In-memory index of the morph presets in the presets folder.  refresh() lists the folder and
+	/// keeps the parsed morph names of every file whose modification time and size did not change;
+	/// a preset is parsed the first time it is used and re-parsed only after it changes on disk.
+	///
+	/// Two file types are indexed:
+	///   *.csv          the text presets written by the morph selection dialog ("Name","Export" lines)
+	///   *.morphpreset  binary presets (little endian): char[4] "DZMP", uint32 version, uint32 count,
+	///                  then count x (uint32 byte length + UTF-8 morph name)
+	/// </summary>
+	class CPP_Export DzBridgeMorphPresetIndex {
+	public:
+		DzBridgeMorphPresetIndex() {}
+
+		void setFolder(const QString& sFolder);
+		const QString& getFolder() const { return m_sFolder; }
+
+		// Lists the folder again, dropping entries for removed files and parsed names of changed files
+		void refresh();
+		void clear();
+
+		// Preset file names relative to the folder, in folder listing order
+		const QStringList& getPresetNames() const { return m_aPresetNames; }
+
+		// Names of the morphs the preset exports, in file order.  Parses the file if it is new or
+		// changed since it was last parsed.  Returns false if the file can not be read.
+		bool getMorphNames(const QString& sPresetName, QStringList& aMorphNames);
+
+		static bool readCsvPreset(const QString& sFilePath, QStringList& aMorphNames);
+		static bool readBinaryPreset(const QString& sFilePath, QStringList& aMorphNames);
+		static bool writeBinaryPreset(const QString& sFilePath, const QStringList& aMorphNames);
+		static bool isBinaryPreset(const QString& sFilePath) { return sFilePath.endsWith(".morphpreset", Qt::CaseInsensitive); }
+
+	private:
+		struct PresetEntry
+		{
+			QDateTime Modified;
+			qint64 Size;
+			bool Parsed;
+			QStringList MorphNames;
+		};
+
+		QString m_sFolder;
+		QStringList m_aPresetNames;
+		QHash<QString, PresetEntry> m_mPresets;
+	};
+
+}
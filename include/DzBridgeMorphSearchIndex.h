@@ -0,0 +1,45 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmap.h>
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	struct MorphInfo;
+
+	/// <summary>
+	/// Trigram index over the lowercase labels of all morphs found by PrepareDialog().
+	/// Morphs are referred to by id (their position in the morph map).  A query returns the ids
+	/// whose label contains the filter text (case insensitive), optionally restricted to a candidate
+	/// list such as the previous result set, which lets typing refine results incrementally.
+	/// </summary>
+	class CPP_Export DzBridgeMorphSearchIndex {
+	public:
+		DzBridgeMorphSearchIndex() {}
+
+		void build(const QMap<QString, MorphInfo>& morphs);
+		void clear();
+
+		int getNumMorphs() const { return m_aNames.count(); }
+		int findId(const QString& sMorphName) const { return m_mNameToId.value(sMorphName, -1); }
+		const QString& getName(int nId) const { return m_aNames[nId]; }
+		const QString& getLabel(int nId) const { return m_aLabels[nId]; }
+
+		// Returns the ids (ascending) whose label contains sFilter.
+		// pCandidates, when given, must be ascending and limits the search to those ids.
+		QVector<int> query(const QString& sFilter, const QVector<int>* pCandidates = nullptr) const;
+
+	private:
+		static quint64 trigramKey(const QChar* pChars);
+		static QVector<int> intersect(const QVector<int>& a, const QVector<int>& b);
+
+		QVector<QString> m_aNames;
+		QVector<QString> m_aLabels;
+		QVector<QString> m_aLowerLabels;
+		QHash<QString, int> m_mNameToId;
+		QHash<quint64, QVector<int>> m_mTrigrams;
+	};
+
+}
@@ -4,12 +4,18 @@
 #include <QtGui/qcombobox.h>
 #include <QtGui/qcheckbox.h>
 #include <QtCore/qsettings.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qpointer.h>
 #include "dznode.h"
+#include "DzBridgeMorphLinkGraph.h"
+#include "DzBridgeMorphSearchIndex.h"
+#include "DzBridgeMorphPresetIndex.h"
 
 class QListWidget;
 class QListWidgetItem;
-class QTreeWidget;
-class QTreeWidgetItem;
+class QTreeView;
+class QModelIndex;
 class QLineEdit;
 class QComboBox;
 class QCheckBox;
@@ -45,12 +51,90 @@ namespace DzBridgeNameSpace
 		}
 	};
 
+	// Where a cached morph's property lives: node (0 = figure, 1.. = children), morph modifier (-1 = node property), property
+	struct MorphCatalogLocation {
+		qint32 NodeIndex;
+		qint32 ModifierIndex;
+		qint32 PropertyIndex;
+
+		MorphCatalogLocation()
+		{
+			NodeIndex = -1;
+			ModifierIndex = -1;
+			PropertyIndex = -1;
+		}
+	};
+
+	/// <summary>
+	/// Ordered set of MorphInfo keyed by morph name.  Iteration follows insertion order,
+	/// membership tests and lookups by name are O(1).  Supports foreach().
+	/// </summary>
+	class MorphInfoRegistry
+	{
+	public:
+		typedef QVector<MorphInfo>::const_iterator const_iterator;
+
+		const_iterator begin() const { return m_aMorphs.constBegin(); }
+		const_iterator end() const { return m_aMorphs.constEnd(); }
+
+		int length() const { return m_aMorphs.count(); }
+		int count() const { return m_aMorphs.count(); }
+		bool isEmpty() const { return m_aMorphs.isEmpty(); }
+		const MorphInfo& at(int nIndex) const { return m_aMorphs[nIndex]; }
+
+		bool contains(const QString& sName) const { return m_mNameToIndex.contains(sName); }
+		bool contains(const MorphInfo& morph) const { return m_mNameToIndex.contains(morph.Name); }
+
+		MorphInfo value(const QString& sName) const
+		{
+			int nIndex = m_mNameToIndex.value(sName, -1);
+			return (nIndex == -1) ? MorphInfo() : m_aMorphs[nIndex];
+		}
+
+		// Returns false if a morph with the same name is already registered
+		bool append(const MorphInfo& morph)
+		{
+			if (m_mNameToIndex.contains(morph.Name))
+				return false;
+			m_mNameToIndex.insert(morph.Name, m_aMorphs.count());
+			m_aMorphs.append(morph);
+			return true;
+		}
+
+		// Keeps the order of the remaining morphs
+		bool remove(const QString& sName)
+		{
+			int nIndex = m_mNameToIndex.value(sName, -1);
+			if (nIndex == -1)
+				return false;
+			m_aMorphs.remove(nIndex);
+			m_mNameToIndex.remove(sName);
+			for (int i = nIndex; i < m_aMorphs.count(); i++)
+			{
+				m_mNameToIndex[m_aMorphs[i].Name] = i;
+			}
+			return true;
+		}
+		bool remove(const MorphInfo& morph) { return remove(morph.Name); }
+
+		void clear()
+		{
+			m_aMorphs.clear();
+			m_mNameToIndex.clear();
+		}
+
+	private:
+		QVector<MorphInfo> m_aMorphs;
+		QHash<QString, int> m_mNameToIndex;
+	};
+
 	struct JointLinkKey
 	{
-		int Angle;
-		int Value;
+		double Angle;
+		double Value;
 	};
 
+	// Minimum/Maximum is the input range of the key curve (see DzBridgeMorphLinkGraph::getKeyCurveRange)
 	struct JointLinkInfo
 	{
 		QString Bone;
@@ -58,9 +142,14 @@ namespace DzBridgeNameSpace
 		QString Morph;
 		double Scalar;
 		double Alpha;
-		QList<JointLinkKey> Keys;
+		int KeyInterpolation;
+		double Minimum;
+		double Maximum;
+		QVector<JointLinkKey> Keys;
 	};
 
+	class DzBridgeMorphTreeModel;
+
 	class CPP_Export DzBridgeMorphSelectionDialog : public DzBasicDialog {
 		Q_OBJECT
 	public:
@@ -98,6 +187,7 @@ namespace DzBridgeNameSpace
 		Q_INVOKABLE bool IsAutoJCMEnabled() { return autoJCMCheckBox->isChecked(); }
 
 		// Recursive function for finding all active JCM morphs for a node
+		// The result is cached per figure until InvalidateJointControlledMorphs() is called
 		Q_INVOKABLE QList<JointLinkInfo> GetActiveJointControlledMorphs(DzNode* Node = nullptr);
 
 		// Retrieve label based on morph name
@@ -113,6 +203,17 @@ namespace DzBridgeNameSpace
 		Q_INVOKABLE static QString getMorphPropertyName(DzProperty* pMorphProperty);
 		Q_INVOKABLE QList<QString> getMorphNamesToDisconnectList();
 
+		// Morphs currently in the export list, in export order
+		const MorphInfoRegistry& GetMorphsToExport() { EnsureMorphCatalogVerified(); return morphsToExport; }
+
+		// Maximum number of links HandleAddConnectedMorphs() follows from the export list, 0 = no limit
+		Q_INVOKABLE int GetConnectedMorphsDepthLimit() { return connectedMorphsDepthLimit; }
+		Q_INVOKABLE void SetConnectedMorphsDepthLimit(int depthLimit) { connectedMorphsDepthLimit = depthLimit; }
+
+		// Verify a morph catalog loaded from cache now instead of waiting for the deferred check.
+		// Called by everything that needs MorphInfo::Property.
+		Q_INVOKABLE void EnsureMorphCatalogVerified();
+
 	public slots:
 		void FilterChanged(const QString& filter);
 		void ItemSelectionChanged();
@@ -127,13 +228,15 @@ namespace DzBridgeNameSpace
 		void HandleFaceFXGenesis8Button();
 		void HandleAutoJCMCheckBoxChange(bool checked);
 		void HandleAddConnectedMorphs();
+		void VerifyMorphCatalog();
+		void InvalidateJointControlledMorphs();
 
 	private:
 		// check if Morph is Valid
 		bool isValidMorph(DzProperty* pMorphProperty);
 
-		// Refresh the list of possible presets from disk
-		void RefreshPresetsCombo();
+		// Refresh the list of possible presets, bRescan lists the presets folder again first
+		void RefreshPresetsCombo(bool bRescan = false);
 
 		// Recursive function for finding all morphs for a node
 		QStringList GetAvailableMorphs(DzNode* Node);
@@ -143,28 +246,64 @@ namespace DzBridgeNameSpace
 
 		void UpdateMorphsTree();
 
-		// Returns the tree node for the morph name (with path)
-		// Builds out the structure of the tree as needed.
-		QTreeWidgetItem* FindTreeItem(QTreeWidgetItem* parent, QString name);
+		// Full morph scan of the figure and children (fills morphs)
+		void ScanMorphs(DzNode* Node);
+
+		// Rebuild search index and left tree after morphs changed
+		void RefreshMorphViews();
+
+		// Per-figure morph catalog cache, keyed by asset id and verified by a modifier fingerprint
+		QString GetMorphCatalogPath(DzNode* Node);
+		QString GetMorphCatalogFingerprint(DzNode* Node);
+		bool LoadMorphCatalog(QString filePath);
+		void SaveMorphCatalog(QString filePath, DzNode* Node);
+		bool ResolveMorphCatalog(DzNode* Node, bool& bLabelsChanged);
 
 		void SavePresetFile(QString filePath);
 
 		// Updates selectedInTree to have all the morphs for the nodes
 		// selected in the left tree
-		void SelectMorphsInNode(QTreeWidgetItem* item);
+		void SelectMorphsInNode(const QModelIndex& index);
 
 		// Rebuild the right box that lists all the morphs that will export.
 		void RefreshExportMorphList();
 
-		// Morphs currently selected in the left tree box
-		QList<MorphInfo> selectedInTree;
+		// Morphs currently selected in the left tree box (morphSearchIndex ids, ascending)
+		QVector<int> selectedInTree;
+
+		// Search index over all morph labels, rebuilt in PrepareDialog
+		DzBridgeMorphSearchIndex morphSearchIndex;
+
+		// Last filter text (lowercase) and its result, used to refine the next filter incrementally
+		QString lastFilter;
+		QVector<int> lastFilterResult;
 
 		// List of morphs moved to the export box
-		QList<MorphInfo> morphsToExport;
+		MorphInfoRegistry morphsToExport;
 
 		// Store off the presetsFolder path at dialog setup
 		QString presetsFolder;
 
+		// Presets in presetsFolder with their parsed morph names, rescanned in PrepareDialog and after saving
+		DzBridgeMorphPresetIndex presetIndex;
+
+		// Morph catalog cache state
+		QString morphCatalogFolder;
+		QString morphCatalogPath;
+		QString morphCatalogFingerprint;
+		QPointer<DzNode> morphCatalogNode;
+		QHash<QString, MorphCatalogLocation> morphCatalogLocations;
+		bool morphCatalogPending;
+
+		// See SetConnectedMorphsDepthLimit()
+		int connectedMorphsDepthLimit;
+
+		// Cached result of GetActiveJointControlledMorphs(), and the objects whose changes invalidate it
+		QPointer<DzNode> jointLinkCacheNode;
+		QList<JointLinkInfo> jointLinkCache;
+		bool jointLinkCacheValid;
+		QList<QPointer<QObject>> jointLinkCacheWatched;
+
 		static DzBridgeMorphSelectionDialog* singleton;
 
 		// A list of all found morphs.
@@ -177,9 +316,9 @@ namespace DzBridgeNameSpace
 		//TODO: morphNameMapping (and others) should be replaced by this
 		QMap<QString, MorphInfo> morphs;
 
-		// List of morphs (recursive) under each tree node
-		// For convenience populating the middle box.
-		QMap<QTreeWidgetItem*, QList<MorphInfo>> morphsForNode;
+		// ERC links between morph properties, filled on demand and cleared in PrepareDialog
+		DzBridgeMorphLinkGraph morphLinkGraph;
+
 
 		// Force the size of the dialog
 		QSize minimumSizeHint() const override;
@@ -187,12 +326,12 @@ namespace DzBridgeNameSpace
 		// Widgets the dialog will access after construction
 		QListWidget* morphListWidget;
 		QListWidget* morphExportListWidget;
-		QTreeWidget* morphTreeWidget;
+		QTreeView* morphTreeView;
+		// Morph path tree, also holds the list of morphs (recursive) under each tree node
+		DzBridgeMorphTreeModel* morphTreeModel;
 		QLineEdit* filterEdit;
 		QComboBox* presetCombo;
 
-		QTreeWidgetItem* fullBodyMorphTreeItem;
-		QTreeWidgetItem* charactersTreeItem;
 		QCheckBox* autoJCMCheckBox;
 
 		QSettings* settings;
@@ -0,0 +1,63 @@
+#pragma once
+#include <QtCore/qabstractitemmodel.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmap.h>
+
+#include "DzBridgeMorphSelectionDialog.h"
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// Item model for the "Morph Groups" tree of DzBridgeMorphSelectionDialog.
+	/// setMorphs() builds a trie of the morph paths in one pass, each trie node holding the
+	/// indices of all morphs at or below it.  Only the top level is exposed after a reset;
+	/// children are handed to the view through canFetchMore()/fetchMore() when a node is expanded.
+	/// </summary>
+	class CPP_Export DzBridgeMorphTreeModel : public QAbstractItemModel {
+		Q_OBJECT
+	public:
+		DzBridgeMorphTreeModel(QObject* parent = nullptr);
+		virtual ~DzBridgeMorphTreeModel();
+
+		// Rebuild the tree from the morph paths (e.g. "Genesis 8 Female/Morphs/Head")
+		void setMorphs(const QMap<QString, MorphInfo>& morphs);
+		void clear();
+
+		// All morphs at or below the node
+		QList<MorphInfo> getMorphsForIndex(const QModelIndex& index) const;
+
+		QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+		QModelIndex parent(const QModelIndex& index) const override;
+		int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+		int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+		QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+		bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+		bool canFetchMore(const QModelIndex& parent) const override;
+		void fetchMore(const QModelIndex& parent) override;
+
+	private:
+		struct TreeNode
+		{
+			QString Name;
+			TreeNode* Parent;
+			int Row;
+			int NumFetched;
+			QVector<TreeNode*> Children;
+			QHash<QString, TreeNode*> ChildByName;
+			QVector<int> Morphs;
+
+			TreeNode(const QString& sName, TreeNode* pParent, int nRow) :
+				Name(sName), Parent(pParent), Row(nRow), NumFetched(0) {}
+			~TreeNode() { qDeleteAll(Children); }
+		};
+
+		TreeNode* nodeFromIndex(const QModelIndex& index) const;
+		TreeNode* findOrAddChild(TreeNode* pParent, const QString& sName);
+
+		TreeNode* m_pRoot;
+		QVector<MorphInfo> m_aMorphs;
+	};
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <QtCore/qstring.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qvector.h>
+
+#include "dzbridge.h"
+
+class DzFacetMesh;
+
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// Writes Wavefront OBJ files directly from DzFacetMesh buffers, replacing a round-trip through
+	/// DzObjExporter.  Text is formatted into a large in-memory buffer with a fixed-precision float
+	/// formatter and flushed to disk in big blocks.  Vertex lines of large meshes are formatted in
+	/// parallel blocks (QtConcurrent) and then appended in order, so output is identical either way.
+	///
+	/// Options have the same meaning as the DzObjExporter settings of the same name:
+	///   WeldSeams: vertices of a mesh at exactly the same position are written once
+	///   RemoveUnusedVerts: vertices not referenced by any facet are skipped
+	///   WriteVT / WriteVN: write texture coordinates / vertex normals and reference them from faces
+	/// Indices are global across all meshes written to the same file, as OBJ requires.
+	/// </summary>
+	class CPP_Export DzBridgeObjWriter {
+	public:
+		DzBridgeObjWriter();
+		~DzBridgeObjWriter();
+
+		void setWeldSeams(bool bWeldSeams) { m_bWeldSeams = bWeldSeams; }
+		void setRemoveUnusedVerts(bool bRemoveUnusedVerts) { m_bRemoveUnusedVerts = bRemoveUnusedVerts; }
+		void setWriteVT(bool bWriteVT) { m_bWriteVT = bWriteVT; }
+		void setWriteVN(bool bWriteVN) { m_bWriteVN = bWriteVN; }
+		void setFloatPrecision(int nFloatPrecision) { m_nFloatPrecision = qBound(0, nFloatPrecision, 8); }
+		void setParallel(bool bParallel) { m_bParallel = bParallel; }
+
+		bool open(const QString& sFilename);
+		// Appends one mesh, using its current vertex positions.  Returns false if nothing could be written.
+		bool writeMesh(DzFacetMesh* pMesh);
+		bool close();
+
+		// Formats fValue with exactly nPrecision (at most 8) decimals into pBuffer, like printf("%.*f"),
+		// including the sign of negative values that round to zero.  NaN, infinity and values of 9e18 / 10^nPrecision
+		// and above are passed on to qsnprintf("%.*f").  Returns the end of the written text.
+		// pBuffer needs room for at least 64 characters.
+		static char* formatFloat(char* pBuffer, float fValue, int nPrecision);
+
+	private:
+		void appendLine(char cPrefix0, char cPrefix1, const float* pValues, int nNumValues);
+		void formatVertexBlock(QByteArray& block, const float* pPositions, const QVector<int>& aOutputVertices, int nBegin, int nEnd) const;
+		void flush(bool bForce);
+
+		QFile m_File;
+		QByteArray m_Buffer;
+		bool m_bOk;
+
+		bool m_bWeldSeams;
+		bool m_bRemoveUnusedVerts;
+		bool m_bWriteVT;
+		bool m_bWriteVN;
+		int m_nFloatPrecision;
+		bool m_bParallel;
+
+		// 1-based OBJ index of the first vertex / uv / normal of the next mesh
+		int m_nVertexOffset;
+		int m_nUVOffset;
+		int m_nNormalOffset;
+	};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <QtCore/qiodevice.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+struct zip_t;
+
+#include "dzbridge.h"
+namespace DzBridgeNameSpace
+{
+	/// <summary>
+	/// Write-only QIODevice which streams everything written to it into a single compressed
+	/// entry of a new zip archive, using the bundled miniz/zip library.  Output is compressed
+	/// in blocks as it is produced, so DzJsonWriter can write a DTU directly into the archive.
+	///
+	/// Usage:
+	/// DzBridgeZipWriter zipDevice(sZipFilename, "Character.dtu");
+	/// zipDevice.open(QIODevice::WriteOnly);
+	/// DzJsonWriter writer(&zipDevice);
+	/// ...
+	/// zipDevice.close();
+	/// </summary>
+	class CPP_Export DzBridgeZipWriter : public QIODevice {
+	public:
+		DzBridgeZipWriter(QString sZipFilename, QString sEntryName, int nCompressionLevel = 6);
+		virtual ~DzBridgeZipWriter();
+
+		virtual bool open(OpenMode mode);
+		virtual void close();
+		virtual bool isSequential() const { return true; }
+
+		// Returns true if the file starts with a zip local file header
+		static bool isZipFile(QString sFilename);
+		// Returns the contents of the first entry of a zip archive
+		static QByteArray readFirstEntry(QString sZipFilename);
+
+	protected:
+		virtual qint64 readData(char* data, qint64 maxSize);
+		virtual qint64 writeData(const char* data, qint64 maxSize);
+
+	private:
+		bool flushBuffer();
+
+		QString m_sZipFilename;
+		QString m_sEntryName;
+		int m_nCompressionLevel;
+		struct zip_t* m_pZip;
+		QByteArray m_Buffer;
+	};
+
+}
@@ -1,12 +1,57 @@
 #pragma once
 
 #include <fbxsdk.h>
+#include <opensubdiv/far/topologyRefiner.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
 class OpenSubdivInterface
 {
 
 };
 
+// Uniformly refined topology of one base mesh at one SubD level.  The stencils express the finest level
+// vertices in the base vertices (factorized Far::StencilTable, kept as plain arrays so they can be cached
+// on disk), so any vertex-interpolated primvar (positions, skin weights, morph deltas, per-vertex UVs)
+// is refined with one stencil evaluation.
+struct SubdivisionTopology
+{
+    int SubDLevel;
+    int NumCoarseVerts;
+    int NumFineVerts;
+    double BuildMilliseconds; // time RefineUniform() and the stencil table took when the topology was built
+    std::vector<int> FineFaceOffsets; // NumFineFaces + 1 entries into FineFaceVertices
+    std::vector<int> FineFaceVertices;
+    std::vector<int> StencilSizes; // NumFineVerts entries
+    std::vector<int> StencilOffsets;
+    std::vector<int> StencilIndices;
+    std::vector<float> StencilWeights;
+
+    // Inverse of the stencils: the fine vertices each base vertex contributes to (ascending), see BuildCoarseToFine()
+    std::vector<int> CoarseToFineOffsets;
+    std::vector<int> CoarseToFine;
+
+    SubdivisionTopology() : SubDLevel(0), NumCoarseVerts(0), NumFineVerts(0), BuildMilliseconds(0.0) {}
+    void BuildCoarseToFine();
+
+    // Refines nElements floats per vertex from pCoarse (NumCoarseVerts entries) into pFine (NumFineVerts entries),
+    // evaluating blocks of stencils in parallel on the global thread pool
+    void Refine(const float* pCoarse, float* pFine, int nElements) const;
+
+    // Binary cache file (native byte order, little endian on all supported platforms):
+    //   char[4] "DZST", uint32 version, uint32 byte length + topology key,
+    //   int32 SubDLevel, NumCoarseVerts, NumFineVerts, float64 BuildMilliseconds,
+    //   then FineFaceOffsets, FineFaceVertices, StencilSizes, StencilOffsets, StencilIndices, StencilWeights,
+    //   each as uint32 count + count x 4 bytes
+    // Filenames are UTF-8.
+    bool Save(const std::string& sFilename, const std::string& sKey) const;
+    bool Load(const std::string& sFilename, const std::string& sKey);
+};
+
 // utility class for subdividing FbxScene
 class SubdivideFbxScene
 {
@@ -15,107 +60,92 @@ public:
 	{
 		m_Scene = pScene;
 		m_SubDLevel_NameLookup = pLookupTable;
+		m_bSparseSkinWeights = false;
+		m_nCacheHits = 0;
+		m_nCacheMisses = 0;
+		m_fCacheMillisecondsSaved = 0.0;
 	}
 	virtual ~SubdivideFbxScene() {};
 
+    // Collects all meshes with a SubD level > 0, then subdivides them in parallel on the global thread pool
     bool ProcessScene();
     bool SaveClustersToScene(FbxScene* pDestScene);
 
-protected:
-    bool ProcessNode(FbxNode* pNode);
-    FbxMesh* SubdivideMesh(FbxNode* pNode, FbxMesh* pMesh, int subdLevel);
-    bool SaveClustersToNode(FbxScene* pDestScene, FbxNode* pNode);
-    FbxMesh* SaveClustersToMesh(FbxScene* pDestScene, FbxNode* pNode, FbxMesh* pMesh);
-
-    FbxScene* m_Scene;
-	std::map<std::string, int>* m_SubDLevel_NameLookup;
-	std::map<std::string, FbxMesh*> m_FbxMesh_NameLookup;
-
-    struct Vertex {
-
-        // Minimal required interface ----------------------
-        Vertex() { }
-
-        Vertex(Vertex const& src) {
-            _position[0] = src._position[0];
-            _position[1] = src._position[1];
-            _position[2] = src._position[2];
-        }
-
-        void Clear(void* = 0) {
-            _position[0] = _position[1] = _position[2] = 0.0f;
-        }
-
-        void AddWithWeight(Vertex const& src, float weight) {
-            _position[0] += weight * src._position[0];
-            _position[1] += weight * src._position[1];
-            _position[2] += weight * src._position[2];
-        }
-
-        // Public interface ------------------------------------
-        void SetPosition(float x, float y, float z) {
-            _position[0] = x;
-            _position[1] = y;
-            _position[2] = z;
-        }
-
-        void SetPosition(double x, double y, double z) {
-            _position[0] = (float)x;
-            _position[1] = (float)y;
-            _position[2] = (float)z;
-        }
-
-        void SetVector(FbxVector4 vec) {
-            _position[0] = (float)vec[0];
-            _position[1] = (float)vec[1];
-            _position[2] = (float)vec[2];
-        }
-
-        const float* GetPosition() const {
-            return _position;
-        }
-
-        FbxVector4 GetVector() {
-            return FbxVector4(_position[0], _position[1], _position[2], 1.0f);
-        }
-
-    private:
-        float _position[3];
+    // Per-mesh results of the last ProcessScene(), in scene order
+    struct MeshTiming {
+        std::string Name;
+        int SubDLevel;
+        int CoarseVerts;
+        int FineVerts;
+        double Milliseconds;
     };
+    const std::vector<MeshTiming>& GetMeshTimings() const { return m_MeshTimings; }
 
-    typedef Vertex VertexPosition;
+    // Sparse mode refines each cluster only over the fine vertices its coarse vertices can reach,
+    // so the cost scales with the number of influences instead of bones x vertices.
+    void SetSparseSkinWeights(bool bSparse) { m_bSparseSkinWeights = bSparse; }
+    bool GetSparseSkinWeights() const { return m_bSparseSkinWeights; }
 
-    struct SkinWeight {
+    // Folder (UTF-8) for refined topologies that persist across exports (<key>.subdcache files), empty = memory only.
+    // On a hit RefineUniform() and the stencil table build are skipped.
+    void SetCacheFolder(const std::string& sFolder) { m_sCacheFolder = sFolder; }
+    const std::string& GetCacheFolder() const { return m_sCacheFolder; }
 
-        // Minimal required interface ----------------------
-        SkinWeight() {
-            _weight = 0.0f;
-        }
+    // Topology lookups of the last ProcessScene(): hits from memory or disk, misses that were refined,
+    // and the build time the hits saved minus the time spent loading them
+    int GetCacheHits() const { return m_nCacheHits; }
+    int GetCacheMisses() const { return m_nCacheMisses; }
+    double GetCacheMillisecondsSaved() const;
 
-        SkinWeight(SkinWeight const& src) {
-            _weight = src._weight;
-        }
+    // Refined topology used for the named mesh by the last ProcessScene(), nullptr if it was not subdivided.
+    // Meshes with the same topology and SubD level share one SubdivisionTopology.
+    std::shared_ptr<const SubdivisionTopology> GetSubdivisionTopology(const std::string& meshName) const;
 
-        void Clear(void* = 0) {
-            _weight = 0.0f;
-        }
+    // Key of a base topology: SubD level, subdivision options and a 64-bit FNV-1a hash of the face-vertex lists
+    static std::string GetTopologyKey(const std::vector<int>& numVertsPerFace, const std::vector<int>& vertIndicesPerFace, int numVertices, int subdLevel);
 
-        void AddWithWeight(SkinWeight const& src, float weight) {
-            _weight += weight * src._weight;
-        }
+protected:
+    struct SubdivisionTask {
+        FbxNode* Node;
+        FbxMesh* Mesh;
+        int SubDLevel;
+        FbxMesh* Result;
+        MeshTiming Timing;
+    };
 
-        // Public interface ------------------------------------
-        void SetWeight(float weight) {
-            _weight = weight;
-        }
+    // Interpolated weights of one cluster: fine vertex indices (ascending) with weight > 0
+    struct ClusterWeights {
+        FbxCluster* SourceCluster;
+        std::vector<int> Indices;
+        std::vector<float> Weights;
+    };
 
-        const float GetWeight() const {
-            return _weight;
-        }
+    bool ProcessNode(FbxNode* pNode);
+    // Thread safe: works on its own buffers and only locks m_FbxSceneMutex to create the FBX objects
+    FbxMesh* SubdivideMesh(FbxNode* pNode, FbxMesh* pMesh, int subdLevel);
+    // Returns the topology for the key from memory or the cache folder, or refines the base mesh and builds its stencil table
+    std::shared_ptr<SubdivisionTopology> GetOrCreateTopology(const std::vector<int>& numVertsPerFace, const std::vector<int>& vertIndicesPerFace, int numVertices, int subdLevel);
+    static std::shared_ptr<SubdivisionTopology> CreateTopology(const std::vector<int>& numVertsPerFace, const std::vector<int>& vertIndicesPerFace, int numVertices, int subdLevel);
+    void InterpolateSkinWeights(const SubdivisionTopology& topology, std::vector<ClusterWeights*>& allClusterWeights);
+    void InterpolateSkinWeightsSparse(const SubdivisionTopology& topology, std::vector<ClusterWeights*>& allClusterWeights);
+    bool SaveClustersToNode(FbxScene* pDestScene, FbxNode* pNode);
+    FbxMesh* SaveClustersToMesh(FbxScene* pDestScene, FbxNode* pNode, FbxMesh* pMesh);
 
-    private:
-        float _weight;
-    };
+    FbxScene* m_Scene;
+	std::map<std::string, int>* m_SubDLevel_NameLookup;
+	std::map<std::string, FbxMesh*> m_FbxMesh_NameLookup;
+	std::vector<SubdivisionTask> m_SubdivisionTasks;
+	std::vector<MeshTiming> m_MeshTimings;
+	std::mutex m_FbxSceneMutex;
+	bool m_bSparseSkinWeights;
+
+	// topology key -> refined topology, and mesh name -> refined topology; guarded by m_TopologyMutex
+	std::map<std::string, std::shared_ptr<SubdivisionTopology>> m_TopologyCache;
+	std::map<std::string, std::shared_ptr<SubdivisionTopology>> m_Topology_NameLookup;
+	mutable std::mutex m_TopologyMutex;
+	std::string m_sCacheFolder;
+	std::atomic<int> m_nCacheHits;
+	std::atomic<int> m_nCacheMisses;
+	double m_fCacheMillisecondsSaved; // guarded by m_TopologyMutex
 
 };
-
@@ -28,6 +28,7 @@
 #include <dzpresentation.h>
 #include <dzmodifier.h>
 #include <dzmorph.h>
+#include <dzmorphdeltas.h>
 #include <dzprogress.h>
 #include <dztexture.h>
 #include <dzimagemgr.h>
@@ -49,6 +50,7 @@
 
 
 #include <QtCore/qdir.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtGui/qlineedit.h>
 #include <QtNetwork/qudpsocket.h>
 #include <QtNetwork/qabstractsocket.h>
@@ -60,6 +62,7 @@
 #include "DzBridgeDialog.h"
 #include "DzBridgeSubdivisionDialog.h"
 #include "DzBridgeMorphSelectionDialog.h"
+#include "DzBridgeZipWriter.h"
 
 using namespace DzBridgeNameSpace;
 
@@ -75,6 +78,7 @@ DzBridgeAction::DzBridgeAction(const QString& text, const QString& desc) :
 	m_morphSelectionDialog = nullptr;
 	m_bGenerateNormalMaps = false;
 	m_pSelectedNode = nullptr;
+	m_pControlledMeshIndexNode = nullptr;
 
 #ifdef _DEBUG
 	 m_bUndoNormalMaps = false;
@@ -97,6 +101,13 @@ void DzBridgeAction::resetToDefaults()
 	m_EnableSubdivisions = false;
 	m_bShowFbxOptions = false;
 	m_bExportMaterialPropertiesCSV = false;
+	m_bExportMaterialPropertiesBinary = false;
+	m_MaterialPropertyTable.clear();
+	m_bUseMaterialTemplates = false;
+	m_mMaterialTemplates.clear();
+	m_nMaterialPropertiesWritten = 0;
+	m_nMaterialPropertiesOmitted = 0;
+	m_mMaterialPropertyFilter.clear();
 	resetArray_ControllersToDisconnect();
 
 	// Reset all dialog settings and script-exposed properties to Hardcoded Defaults
@@ -133,6 +144,16 @@ void DzBridgeAction::resetToDefaults()
 	m_sProductComponentName = "";
 	m_aMorphListOverride.clear();
 	m_bUseRelativePaths = false;
+	m_bCompressDtu = false;
+	m_bExportMorphDeltas = false;
+	m_bQuantizeMorphDeltas = false;
+	m_bExportMorphBasis = false;
+	m_nMorphBasisComponents = 0;
+	m_nJCMLookupTableSize = 0;
+	m_bSparseSubdivisionWeights = false;
+	m_sSubdivisionCacheFolder = "";
+	m_bExportGeograftMorphDeltas = false;
+	m_bUseLegacyObjExporter = false;
 	m_bUndoNormalMaps = true;
 	m_nNonInteractiveMode = 0;
 	m_undoTable_DuplicateMaterialRename.clear();
@@ -742,8 +763,8 @@ void DzBridgeAction::exportHD(DzProgress* exportProgress)
 		exportProgress->setInfo(tr("Mesh exported."));
 	}
 
-	// Export any geograft morphs if exist
-	if (m_bEnableMorphs)
+	// Export any geograft morphs if exist, the .bytes file is written with the DTU by writeGeograftMorphs()
+	if (m_bEnableMorphs && m_bExportGeograftMorphDeltas == false)
 	{
 		if (exportGeograftMorphs(dzScene->getPrimarySelection(), m_sDestinationPath))
 		{
@@ -904,72 +925,73 @@ void DzBridgeAction::exportAsset()
 
 		m_aPoseList.clear();
 		DzNode* Selection = dzScene->getPrimarySelection();
+		QList<QPair<QString, DzNumericProperty*>> aPoseProperties = getPoseMorphProperties(Selection);
+		int nNumPoses = aPoseProperties.count();
+		DzTimeRange oOriginalAnimRange = dzScene->getAnimRange();
+		DzTimeRange oOriginalPlayRange = dzScene->getPlayRange();
+		DzTime nTimeStep = dzScene->getTimeStep();
+
+		// Pose N is keyed 0 at frame N-1, 1 at frame N and 0 at frame N+1, plus 0 at the first frame and its value at
+		// the last frame.  The keys are made linear, so every frame reads exactly 1 at frame N and 0 elsewhere, the same
+		// values as keying every pose on every frame.  Spline keys would overshoot between the sparse keys.
+		// Signals are blocked so each key does not trigger a scene re-evaluation.
+		QList<double> aOriginalValues;
 		int poseIndex = 0;
-		DzNumericProperty* previousProperty = nullptr;
-		for (int index = 0; index < Selection->getNumProperties(); index++)
+		foreach(auto posePair, aPoseProperties)
 		{
-			DzProperty* property = Selection->getProperty(index);
-			DzNumericProperty* numericProperty = qobject_cast<DzNumericProperty*>(property);
-			QString propName = property->getName();
-			if (numericProperty)
+			poseIndex++;
+			DzNumericProperty* numericProperty = posePair.second;
+			aOriginalValues.append(numericProperty->getDoubleValue());
+			bool bSignalsBlocked = numericProperty->blockSignals(true);
+			numericProperty->deleteAllKeys();
+			DzFloatProperty* floatProperty = qobject_cast<DzFloatProperty*>(numericProperty);
+			if (floatProperty)
 			{
-				QString propName = property->getName();
-				if (m_mMorphNameToLabel.contains(propName))
+				floatProperty->setDoubleValue(0, 0.0f);
+				floatProperty->setDoubleValue(nTimeStep * (poseIndex - 1), 0.0f);
+				floatProperty->setDoubleValue(nTimeStep * poseIndex, 1.0f);
+				if (poseIndex < nNumPoses)
+					floatProperty->setDoubleValue(nTimeStep * (poseIndex + 1), 0.0f);
+				floatProperty->setDoubleValue(nTimeStep * nNumPoses, (poseIndex == nNumPoses) ? 1.0f : 0.0f);
+				for (int nKey = 0; nKey < floatProperty->getNumKeys(); nKey++)
 				{
-					poseIndex++;
-					numericProperty->setDoubleValue(0.0f, 0.0f);
-					for (int frame = 0; frame < m_mMorphNameToLabel.count() + 1; frame++)
-					{
-						numericProperty->setDoubleValue(dzScene->getTimeStep() * double(frame), 0.0f);
-					}
-					numericProperty->setDoubleValue(dzScene->getTimeStep() * double(poseIndex),1.0f);
-					m_aPoseList.append(propName);
+					floatProperty->setKeyInterpolation(nKey, DzProperty::LinearInterp);
 				}
 			}
-		}
-
-		DzObject* Object = Selection->getObject();
-		if (Object)
-		{
-			for (int index = 0; index < Object->getNumModifiers(); index++)
+			else
 			{
-				DzModifier* modifier = Object->getModifier(index);
-				DzMorph* mod = qobject_cast<DzMorph*>(modifier);
-				if (mod)
+				// no key interpolation to set, key every frame
+				for (int frame = 0; frame <= nNumPoses; frame++)
 				{
-					for (int propindex = 0; propindex < modifier->getNumProperties(); propindex++)
-					{
-						DzProperty* property = modifier->getProperty(propindex);
-						QString propName = property->getName();
-						QString propLabel = property->getLabel();
-						DzNumericProperty* numericProperty = qobject_cast<DzNumericProperty*>(property);
-						if (numericProperty)
-						{
-							QString propName = property->getName();
-							//qDebug() << propName;
-							if (m_mMorphNameToLabel.contains(modifier->getName()))
-							{
-								poseIndex++;
-								numericProperty->setDoubleValue(0.0f, 0.0f);
-								for (int frame = 0; frame < m_mMorphNameToLabel.count() + 1; frame++)
-								{
-									numericProperty->setDoubleValue(dzScene->getTimeStep() * double(frame), 0.0f);
-								}
-								numericProperty->setDoubleValue(dzScene->getTimeStep() * double(poseIndex), 1.0f);
-								m_aPoseList.append(modifier->getName());
-							}
-						}
-					}
-
+					numericProperty->setDoubleValue(nTimeStep * frame, (frame == poseIndex) ? 1.0f : 0.0f);
 				}
-
 			}
+			numericProperty->blockSignals(bSignalsBlocked);
+			m_aPoseList.append(posePair.first);
+		}
+		// The keys were written with signals blocked and the value at the current time may be unchanged, so setting
+		// it again would not emit anything: notify the scene explicitly, once per property.
+		foreach(auto posePair, aPoseProperties)
+		{
+			QMetaObject::invokeMethod(posePair.second, "currentValueChanged");
 		}
 
-		dzScene->setAnimRange(DzTimeRange(0, poseIndex * dzScene->getTimeStep()));
-		dzScene->setPlayRange(DzTimeRange(0, poseIndex * dzScene->getTimeStep()));
+		dzScene->setAnimRange(DzTimeRange(0, poseIndex * nTimeStep));
+		dzScene->setPlayRange(DzTimeRange(0, poseIndex * nTimeStep));
 
 		exportNode(Selection);
+
+		// remove the pose keys, restore the values from before the export and the timeline
+		for (int nPose = 0; nPose < aPoseProperties.count(); nPose++)
+		{
+			DzNumericProperty* numericProperty = aPoseProperties[nPose].second;
+			bool bSignalsBlocked = numericProperty->blockSignals(true);
+			numericProperty->deleteAllKeys();
+			numericProperty->blockSignals(bSignalsBlocked);
+			numericProperty->setDoubleValue(aOriginalValues[nPose]);
+		}
+		dzScene->setAnimRange(oOriginalAnimRange);
+		dzScene->setPlayRange(oOriginalPlayRange);
 	}
 	else if (m_sAssetType == "SkeletalMesh")
 	{
@@ -1521,6 +1543,7 @@ bool DzBridgeAction::checkForIrreversibleOperations_in_disconnectOverrideControl
 	if (Selection == nullptr)
 		return false;
 
+	QSet<QString> aControllersToDisconnect = m_ControllersToDisconnect.toSet();
 	DzNumericProperty* previousProperty = nullptr;
 	for (int index = 0; index < Selection->getNumProperties(); index++)
 	{
@@ -1529,7 +1552,7 @@ bool DzBridgeAction::checkForIrreversibleOperations_in_disconnectOverrideControl
 		if (numericProperty && !numericProperty->isOverridingControllers())
 		{
 			QString propName = property->getName();
-			if (m_mMorphNameToLabel.contains(propName) && m_ControllersToDisconnect.contains(propName))
+			if (m_mMorphNameToLabel.contains(propName) && aControllersToDisconnect.contains(propName))
 			{
 				double propValue = numericProperty->getDoubleValue();
 				if (propValue != 0)
@@ -1556,7 +1579,7 @@ bool DzBridgeAction::checkForIrreversibleOperations_in_disconnectOverrideControl
 					if (numericProperty && !numericProperty->isOverridingControllers())
 					{
 						QString propName = DzBridgeMorphSelectionDialog::getMorphPropertyName(property);
-						if (m_mMorphNameToLabel.contains(modifier->getName()) && m_ControllersToDisconnect.contains(modifier->getName()))
+						if (m_mMorphNameToLabel.contains(modifier->getName()) && aControllersToDisconnect.contains(modifier->getName()))
 						{
 							double propValue = numericProperty->getDoubleValue();
 							if (propValue != 0)
@@ -1582,6 +1605,7 @@ QList<QString> DzBridgeAction::disconnectOverrideControllers()
 	if (Selection == nullptr)
 		return ModifiedList;
 
+	QSet<QString> aControllersToDisconnect = m_ControllersToDisconnect.toSet();
 	DzNumericProperty* previousProperty = nullptr;
 	for (int index = 0; index < Selection->getNumProperties(); index++)
 	{
@@ -1590,7 +1614,7 @@ QList<QString> DzBridgeAction::disconnectOverrideControllers()
 		if (numericProperty && !numericProperty->isOverridingControllers())
 		{
 			QString propName = property->getName();
-			if (m_mMorphNameToLabel.contains(propName) && m_ControllersToDisconnect.contains(propName))
+			if (m_mMorphNameToLabel.contains(propName) && aControllersToDisconnect.contains(propName))
 			{
 				numericProperty->setOverrideControllers(true);
 
@@ -1619,7 +1643,7 @@ QList<QString> DzBridgeAction::disconnectOverrideControllers()
 					if (numericProperty && !numericProperty->isOverridingControllers())
 					{
 						QString propName = DzBridgeMorphSelectionDialog::getMorphPropertyName(property);
-						if (m_mMorphNameToLabel.contains(modifier->getName()) && m_ControllersToDisconnect.contains(modifier->getName()))
+						if (m_mMorphNameToLabel.contains(modifier->getName()) && aControllersToDisconnect.contains(modifier->getName()))
 						{
 							numericProperty->setOverrideControllers(true);
 
@@ -1709,19 +1733,36 @@ bool DzBridgeAction::checkIfPoseExportIsDestructive()
 	if (Selection == nullptr)
 		return false;
 
-	int poseIndex = 0;
-	DzNumericProperty* previousProperty = nullptr;
+	foreach(auto posePair, getPoseMorphProperties(Selection))
+	{
+		DzNumericProperty* numericProperty = posePair.second;
+		if (!(numericProperty->getKeyRange().getEnd() == 0.0f && numericProperty->getDoubleValue(0.0f) == 0.0f)) return true;
+	}
+
+	return false;
+}
+
+/// <summary>
+/// Returns the numeric properties of Selection that are exported as poses, in pose order: node properties
+/// named in m_mMorphNameToLabel first, then properties of morph modifiers named in m_mMorphNameToLabel.
+/// The QString is the name written to m_aPoseList.
+/// </summary>
+QList<QPair<QString, DzNumericProperty*>> DzBridgeAction::getPoseMorphProperties(DzNode* Selection)
+{
+	QList<QPair<QString, DzNumericProperty*>> aPoseProperties;
+	if (Selection == nullptr)
+		return aPoseProperties;
+
 	for (int index = 0; index < Selection->getNumProperties(); index++)
 	{
 		DzProperty* property = Selection->getProperty(index);
 		DzNumericProperty* numericProperty = qobject_cast<DzNumericProperty*>(property);
-		QString propName = property->getName();
 		if (numericProperty)
 		{
 			QString propName = property->getName();
 			if (m_mMorphNameToLabel.contains(propName))
 			{
-				if (!(numericProperty->getKeyRange().getEnd() == 0.0f && numericProperty->getDoubleValue(0.0f) == 0.0f)) return true;
+				aPoseProperties.append(QPair<QString, DzNumericProperty*>(propName, numericProperty));
 			}
 		}
 	}
@@ -1738,15 +1779,12 @@ bool DzBridgeAction::checkIfPoseExportIsDestructive()
 				for (int propindex = 0; propindex < modifier->getNumProperties(); propindex++)
 				{
 					DzProperty* property = modifier->getProperty(propindex);
-					QString propName = property->getName();
-					QString propLabel = property->getLabel();
 					DzNumericProperty* numericProperty = qobject_cast<DzNumericProperty*>(property);
 					if (numericProperty)
 					{
-						QString propName = property->getName();
 						if (m_mMorphNameToLabel.contains(modifier->getName()))
 						{
-							if (!(numericProperty->getKeyRange().getEnd() == 0.0f && numericProperty->getDoubleValue(0.0f) == 0.0f)) return true;
+							aPoseProperties.append(QPair<QString, DzNumericProperty*>(modifier->getName(), numericProperty));
 						}
 					}
 				}
@@ -1756,7 +1794,7 @@ bool DzBridgeAction::checkIfPoseExportIsDestructive()
 		}
 	}
 
-	return false;
+	return aPoseProperties;
 }
 
 void DzBridgeAction::unlockTranform(DzNode* NodeToUnlock)
@@ -1882,6 +1920,78 @@ void DzBridgeAction::writePropertyTexture(DzJsonWriter& Writer, QString sName, Q
 
 }
 
+/// <summary>
+/// Opens a DTU file for writing.  If m_bCompressDtu is set, the returned device streams the
+/// DTU into a zip archive with a single entry, which keeps the filename but starts with the
+/// zip header ("PK") instead of "{".  Use readDtuFile() to read either format.
+/// </summary>
+/// <returns>opened device to pass to DzJsonWriter, or nullptr if the file could not be created.
+/// Caller must close and delete the device.</returns>
+QIODevice* DzBridgeAction::openDtuFile(QString sDtuFilename)
+{
+	QIODevice* pDevice = nullptr;
+	if (m_bCompressDtu)
+	{
+		pDevice = new DzBridgeZipWriter(sDtuFilename, QFileInfo(sDtuFilename).fileName());
+	}
+	else
+	{
+		pDevice = new QFile(sDtuFilename);
+	}
+
+	if (pDevice->open(QIODevice::WriteOnly) == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to open DTU file for writing: " + sDtuFilename);
+		delete pDevice;
+		return nullptr;
+	}
+
+	return pDevice;
+}
+
+/// <summary>
+/// Returns the JSON text of a DTU file, decompressing it if it was written with m_bCompressDtu.
+/// </summary>
+QString DzBridgeAction::readDtuFile(QString sDtuFilename)
+{
+	if (DzBridgeZipWriter::isZipFile(sDtuFilename))
+	{
+		return QString::fromUtf8(DzBridgeZipWriter::readFirstEntry(sDtuFilename));
+	}
+
+	QFile file(sDtuFilename);
+	if (file.open(QIODevice::ReadOnly) == false)
+		return QString();
+	QString sContents = QString::fromUtf8(file.readAll());
+	file.close();
+
+	return sContents;
+}
+
+/// <summary>
+/// Writes JSON text to a DTU file, as a compressed zip archive if bCompress is true.
+/// Used by scripts such as Localize-JobPool.dsa to rewrite DTU files in their original format.
+/// </summary>
+bool DzBridgeAction::writeDtuFile(QString sDtuFilename, QString sContents, bool bCompress)
+{
+	QIODevice* pDevice = nullptr;
+	if (bCompress)
+		pDevice = new DzBridgeZipWriter(sDtuFilename, QFileInfo(sDtuFilename).fileName());
+	else
+		pDevice = new QFile(sDtuFilename);
+
+	bool bResult = pDevice->open(QIODevice::WriteOnly);
+	if (bResult)
+	{
+		QByteArray data = sContents.toUtf8();
+		bResult = (pDevice->write(data) == data.size());
+		pDevice->close();
+	}
+	delete pDevice;
+
+	return bResult;
+}
+
 void DzBridgeAction::writeDTUHeader(DzJsonWriter& writer)
 {
 	QString sAssetId = "";
@@ -1926,8 +2036,17 @@ void DzBridgeAction::writeAllMaterials(DzNode* Node, DzJsonWriter& Writer, QText
 	if (Node == nullptr)
 		return;
 
+	QElapsedTimer timer;
 	if (!bRecursive)
+	{
+		// Material Templates are rebuilt for each DTU
+		m_mMaterialTemplates.clear();
+		m_nMaterialPropertiesWritten = 0;
+		m_nMaterialPropertiesOmitted = 0;
+		m_MaterialPropertyTable.clear();
+		timer.start();
 		Writer.startMemberArray("Materials", true);
+	}
 
 	DzObject* Object = Node->getObject();
 	DzShape* Shape = Object ? Object->getCurrentShape() : nullptr;
@@ -1990,7 +2109,223 @@ void DzBridgeAction::writeAllMaterials(DzNode* Node, DzJsonWriter& Writer, QText
 	}
 
 	if (!bRecursive)
+	{
+		Writer.finishArray();
+
+		// Material property rows are buffered in columns and written out in blocks
+		if (m_bExportMaterialPropertiesCSV && pCVSStream)
+		{
+			m_MaterialPropertyTable.writeCSV(*pCVSStream);
+		}
+		if (m_bExportMaterialPropertiesBinary)
+		{
+			QString sBinaryFilename = m_sDestinationPath + m_sAssetName + "_Maps.bytes";
+			if (m_MaterialPropertyTable.writeBinary(sBinaryFilename) == false)
+			{
+				dzApp->log("DazBridge: ERROR Unable to write material property table: " + sBinaryFilename);
+			}
+		}
+		m_MaterialPropertyTable.clear();
+
+		if (m_bUseMaterialTemplates)
+		{
+			writeMaterialTemplates(Writer);
+			dzApp->log(QString("DazBridge: Material Templates: wrote %1 of %2 material properties (%3 omitted as defaults) using %4 templates in %5 ms.")
+				.arg(m_nMaterialPropertiesWritten)
+				.arg(m_nMaterialPropertiesWritten + m_nMaterialPropertiesOmitted)
+				.arg(m_nMaterialPropertiesOmitted)
+				.arg(m_mMaterialTemplates.count())
+				.arg(timer.elapsed()));
+		}
+	}
+}
+
+// Write the default property values collected for each shader type by writeMaterialProperty().
+// Importers rebuild a full material by applying the material block's properties on top
+// of the template matching its "Material Type".
+void DzBridgeAction::writeMaterialTemplates(DzJsonWriter& Writer)
+{
+	Writer.startMemberArray("Material Templates", true);
+	foreach(QString sShaderType, m_mMaterialTemplates.keys())
+	{
+		const QMap<QString, MaterialTemplateProperty>& templateTable = m_mMaterialTemplates[sShaderType];
+		Writer.startObject(true);
+		Writer.addMember("Material Type", sShaderType);
+		Writer.startMemberArray("Properties", true);
+		foreach(QString sName, templateTable.keys())
+		{
+			const MaterialTemplateProperty& templateProperty = templateTable[sName];
+			if (templateProperty.bUseNumeric)
+				writePropertyTexture(Writer, sName, templateProperty.sLabel, templateProperty.dValue, templateProperty.sType, QString(""));
+			else
+				writePropertyTexture(Writer, sName, templateProperty.sLabel, templateProperty.sValue, templateProperty.sType, QString(""));
+		}
 		Writer.finishArray();
+		Writer.finishObject();
+	}
+	Writer.finishArray();
+
+}
+
+/// <summary>
+/// Sets the Allow and Deny lists of material property names for a shader type.
+/// Use "*" as shader type to apply the lists to all shader types.  Passing two empty lists
+/// removes the filter for that shader type.
+/// </summary>
+/// <param name="sShaderType">Material Type as returned by DzMaterial::getMaterialName(), or "*"</param>
+/// <param name="aAllowList">If not empty, only these properties are exported</param>
+/// <param name="aDenyList">These properties are never exported</param>
+void DzBridgeAction::setMaterialPropertyFilter(QString sShaderType, QStringList aAllowList, QStringList aDenyList)
+{
+	if (aAllowList.isEmpty() && aDenyList.isEmpty())
+	{
+		m_mMaterialPropertyFilter.remove(sShaderType);
+		return;
+	}
+
+	MaterialPropertyFilter filter;
+	filter.aAllowList = aAllowList.toSet();
+	filter.aDenyList = aDenyList.toSet();
+	m_mMaterialPropertyFilter.insert(sShaderType, filter);
+
+}
+
+/// <summary>
+/// Loads material property filters from a text file and adds them to the current filters.
+/// Each line has the format: Shader Type, Allow|Deny, Property Name, Property Name, ...
+/// Lines starting with "#" are comments.  Use "*" as shader type for all shader types.
+/// Example:
+///   Iray Uber, Allow, Diffuse Color, Cutout Opacity, Normal Map
+///   *, Deny, Line Preview Color
+/// </summary>
+/// <returns>false if file could not be read or contains an invalid line</returns>
+bool DzBridgeAction::loadMaterialPropertyFilter(QString sFilterFilePath)
+{
+	QFile file(sFilterFilePath);
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text) == false)
+	{
+		printf("ERROR: DazBridge: DzBridgeAction.cpp, loadMaterialPropertyFilter(): unable to open file: %s", sFilterFilePath.toLocal8Bit().constData());
+		return false;
+	}
+
+	bool bResult = true;
+	QTextStream in(&file);
+	while (!in.atEnd())
+	{
+		QString sLine = in.readLine().trimmed();
+		if (sLine.isEmpty() || sLine.startsWith("#"))
+			continue;
+
+		QStringList aTokens;
+		foreach(QString sToken, sLine.split(","))
+		{
+			sToken = sToken.trimmed();
+			if (sToken.startsWith("\"") && sToken.endsWith("\"") && sToken.length() >= 2)
+				sToken = sToken.mid(1, sToken.length() - 2);
+			if (sToken.isEmpty() == false)
+				aTokens.append(sToken);
+		}
+
+		QString sListType = aTokens.count() > 1 ? aTokens[1].toLower() : QString();
+		if (aTokens.count() < 3 || (sListType != "allow" && sListType != "deny"))
+		{
+			printf("ERROR: DazBridge: DzBridgeAction.cpp, loadMaterialPropertyFilter(): invalid line: %s", sLine.toLocal8Bit().constData());
+			bResult = false;
+			continue;
+		}
+
+		MaterialPropertyFilter& filter = m_mMaterialPropertyFilter[aTokens[0]];
+		for (int i = 2; i < aTokens.count(); i++)
+		{
+			if (sListType == "allow")
+				filter.aAllowList.insert(aTokens[i]);
+			else
+				filter.aDenyList.insert(aTokens[i]);
+		}
+	}
+	file.close();
+
+	return bResult;
+}
+
+// Returns true if the property is excluded by the Deny list or missing from a non-empty Allow
+// list of either the material's shader type or the "*" filter.
+bool DzBridgeAction::isMaterialPropertyFiltered(DzMaterial* Material, DzProperty* Property)
+{
+	if (Material == nullptr || Property == nullptr)
+		return false;
+
+	QHash<QString, MaterialPropertyFilter>::const_iterator shaderFilter = m_mMaterialPropertyFilter.constFind(Material->getMaterialName());
+	QHash<QString, MaterialPropertyFilter>::const_iterator globalFilter = m_mMaterialPropertyFilter.constFind("*");
+	bool bHasShaderFilter = (shaderFilter != m_mMaterialPropertyFilter.constEnd());
+	bool bHasGlobalFilter = (globalFilter != m_mMaterialPropertyFilter.constEnd());
+	if (!bHasShaderFilter && !bHasGlobalFilter)
+		return false;
+
+	const QString sName = Property->getName();
+	if ((bHasShaderFilter && shaderFilter->aDenyList.contains(sName)) ||
+		(bHasGlobalFilter && globalFilter->aDenyList.contains(sName)))
+	{
+		return true;
+	}
+
+	bool bHasAllowList = false;
+	if (bHasShaderFilter && shaderFilter->aAllowList.isEmpty() == false)
+	{
+		if (shaderFilter->aAllowList.contains(sName))
+			return false;
+		bHasAllowList = true;
+	}
+	if (bHasGlobalFilter && globalFilter->aAllowList.isEmpty() == false)
+	{
+		if (globalFilter->aAllowList.contains(sName))
+			return false;
+		bHasAllowList = true;
+	}
+
+	return bHasAllowList;
+}
+
+// Returns true if the untextured property matches the template value for its shader type.
+// The first material of each shader type seeds the template with the property's default value.
+bool DzBridgeAction::isMaterialTemplateDefault(DzMaterial* Material, DzProperty* Property, QString sLabel, QString sType, QString sValue, double dValue, bool bUseNumeric)
+{
+	if (Material == nullptr || Property == nullptr)
+		return false;
+
+	QString sName = Property->getName();
+	QMap<QString, MaterialTemplateProperty>& templateTable = m_mMaterialTemplates[Material->getMaterialName()];
+	if (templateTable.contains(sName) == false)
+	{
+		MaterialTemplateProperty templateProperty;
+		templateProperty.sLabel = sLabel;
+		templateProperty.sType = sType;
+		templateProperty.sValue = sValue;
+		templateProperty.dValue = dValue;
+		templateProperty.bUseNumeric = bUseNumeric;
+
+		DzColorProperty* ColorProperty = qobject_cast<DzColorProperty*>(Property);
+		DzNumericProperty* NumericProperty = qobject_cast<DzNumericProperty*>(Property);
+		if (ColorProperty)
+		{
+			templateProperty.sValue = ColorProperty->getDefaultColorValue().name();
+		}
+		else if (NumericProperty)
+		{
+			templateProperty.dValue = NumericProperty->getDoubleDefaultValue();
+		}
+		// Image properties have no default value, so the first value found is used
+		templateTable.insert(sName, templateProperty);
+	}
+
+	const MaterialTemplateProperty& templateProperty = templateTable[sName];
+	if (templateProperty.bUseNumeric != bUseNumeric || templateProperty.sType != sType || templateProperty.sLabel != sLabel)
+		return false;
+
+	if (bUseNumeric)
+		return templateProperty.dValue == dValue;
+
+	return templateProperty.sValue == sValue;
 }
 
 void DzBridgeAction::startMaterialBlock(DzNode* Node, DzJsonWriter& Writer, QTextStream* pCVSStream, DzMaterial* Material)
@@ -2030,9 +2365,9 @@ void DzBridgeAction::startMaterialBlock(DzNode* Node, DzJsonWriter& Writer, QTex
 		Writer.addMember("Texture", QString(""));
 		Writer.finishObject();
 
-		if (m_bExportMaterialPropertiesCSV && pCVSStream)
+		if ((m_bExportMaterialPropertiesCSV && pCVSStream) || m_bExportMaterialPropertiesBinary)
 		{
-			*pCVSStream << "2, " << Node->getLabel() << ", " << Material->getName() << ", " << Material->getMaterialName() << ", " << "Asset Type" << ", " << presentationType << ", " << "String" << ", " << "" << endl;
+			m_MaterialPropertyTable.addRow(2, Node->getLabel(), Material->getName(), Material->getMaterialName(), QString("Asset Type"), presentationType, QString("String"), QString(""));
 		}
 	}
 }
@@ -2050,6 +2385,10 @@ void DzBridgeAction::writeMaterialProperty(DzNode* Node, DzJsonWriter& Writer, Q
 	if (Node == nullptr || Material == nullptr || Property == nullptr)
 		return;
 
+	// Skip filtered properties before any value formatting or texture path resolution
+	if (m_mMaterialPropertyFilter.isEmpty() == false && isMaterialPropertyFiltered(Material, Property))
+		return;
+
 	QString Name = Property->getName();
 	QString sLabel = Property->getLabel();
 	QString TextureName = "";
@@ -2104,6 +2443,13 @@ void DzBridgeAction::writeMaterialProperty(DzNode* Node, DzJsonWriter& Writer, Q
 		return;
 	}
 
+	// Untextured properties matching the shader template are written once in "Material Templates"
+	bool bOmitProperty = false;
+	if (m_bUseMaterialTemplates && TextureName == "")
+	{
+		bOmitProperty = isMaterialTemplateDefault(Material, Property, sLabel, dtuPropType, dtuPropValue, dtuPropNumericValue, bUseNumeric);
+	}
+
 	QString dtuTextureName = TextureName;
 	if (TextureName != "")
 	{
@@ -2116,24 +2462,97 @@ void DzBridgeAction::writeMaterialProperty(DzNode* Node, DzJsonWriter& Writer, Q
 			dtuTextureName = exportAssetWithDtu(TextureName, Node->getLabel() + "_" + Material->getName());
 		}
 	}
-	if (bUseNumeric)
-		writePropertyTexture(Writer, Name, sLabel, dtuPropNumericValue, dtuPropType, dtuTextureName);
+	if (bOmitProperty)
+	{
+		m_nMaterialPropertiesOmitted++;
+	}
 	else
-		writePropertyTexture(Writer, Name, sLabel, dtuPropValue, dtuPropType, dtuTextureName);
+	{
+		m_nMaterialPropertiesWritten++;
+		if (bUseNumeric)
+			writePropertyTexture(Writer, Name, sLabel, dtuPropNumericValue, dtuPropType, dtuTextureName);
+		else
+			writePropertyTexture(Writer, Name, sLabel, dtuPropValue, dtuPropType, dtuTextureName);
+	}
 
-	if (m_bExportMaterialPropertiesCSV && pCVSStream)
+	if ((m_bExportMaterialPropertiesCSV && pCVSStream) || m_bExportMaterialPropertiesBinary)
 	{
 		if (bUseNumeric)
-			*pCVSStream << "2, " << Node->getLabel() << ", " << Material->getName() << ", " << Material->getMaterialName() << ", " << Name << ", " << dtuPropNumericValue << ", " << dtuPropType << ", " << TextureName << endl;
+			m_MaterialPropertyTable.addRow(2, Node->getLabel(), Material->getName(), Material->getMaterialName(), Name, dtuPropNumericValue, dtuPropType, TextureName);
 		else
-			*pCVSStream << "2, " << Node->getLabel() << ", " << Material->getName() << ", " << Material->getMaterialName() << ", " << Name << ", " << dtuPropValue << ", " << dtuPropType << ", " << TextureName << endl;
+			m_MaterialPropertyTable.addRow(2, Node->getLabel(), Material->getName(), Material->getMaterialName(), Name, dtuPropValue, dtuPropType, TextureName);
 	}
 	return;
 
 }
 
+void DzBridgeAction::buildControlledMeshIndex(DzNode* pNode)
+{
+	clearControlledMeshIndex();
+	if (pNode == nullptr)
+		return;
+
+	for (auto childIter = pNode->nodeChildrenIterator(); childIter.hasNext(); )
+	{
+		DzFigure* childFigure = qobject_cast<DzFigure*>(childIter.next());
+		if (childFigure == nullptr)
+			continue;
+		QString meshName = childFigure->getName() + ".Shape";
+
+		DzObject* oObject = childFigure->getObject();
+		if (oObject)
+		{
+			for (int nModifierIndex = 0; nModifierIndex < oObject->getNumModifiers(); nModifierIndex++)
+			{
+				DzModifier* oModifier = oObject->getModifier(nModifierIndex);
+				if (oModifier == nullptr)
+					continue;
+				QStringList& meshList = m_mMorphToControlledMeshes[oModifier->getName()];
+				if (meshList.contains(meshName) == false)
+					meshList.append(meshName);
+			}
+		}
+
+		DzSkeleton* childSkeleton = childFigure->getSkeleton();
+		DzSkinBinding* skinBinding = DzSkinBinding::findSkin(childFigure);
+		if (childSkeleton == nullptr || skinBinding == nullptr)
+			continue;
+		for (int nBindingIndex = 0; nBindingIndex < skinBinding->getNumBoneBindings(); nBindingIndex++)
+		{
+			DzBoneBinding* boneBinding = skinBinding->getBoneBinding(nBindingIndex);
+			if (boneBinding == nullptr || boneBinding->getBone() == nullptr)
+				continue;
+			QString sBoneName = boneBinding->getBone()->getName();
+			if (childSkeleton->findBone(sBoneName) == nullptr)
+				continue;
+			QStringList& meshList = m_mBoneToControlledMeshes[sBoneName];
+			if (meshList.contains(meshName) == false)
+				meshList.append(meshName);
+		}
+	}
+
+	m_pControlledMeshIndexNode = pNode;
+}
+
+void DzBridgeAction::clearControlledMeshIndex()
+{
+	m_pControlledMeshIndexNode = nullptr;
+	m_mBoneToControlledMeshes.clear();
+	m_mMorphToControlledMeshes.clear();
+}
+
 QStringList DzBridgeAction::checkForMorphOnChild(DzNode* pNode, QString sMorphName, QStringList& controlledMeshList)
 {
+	if (pNode != nullptr && pNode == m_pControlledMeshIndexNode)
+	{
+		foreach(QString meshName, m_mMorphToControlledMeshes.value(sMorphName))
+		{
+			if (controlledMeshList.contains(meshName) == false)
+				controlledMeshList.append(meshName);
+		}
+		return controlledMeshList;
+	}
+
 	for (auto childIter = pNode->nodeChildrenIterator(); childIter.hasNext(); )
 	{
 		DzFigure* childFigure = qobject_cast<DzFigure*>(childIter.next());
@@ -2157,6 +2576,16 @@ QStringList DzBridgeAction::checkForMorphOnChild(DzNode* pNode, QString sMorphNa
 
 QStringList DzBridgeAction::checkForBoneInChild(DzNode* pNode, QString sBoneName, QStringList &controlledMeshList)
 {
+	if (pNode != nullptr && pNode == m_pControlledMeshIndexNode)
+	{
+		foreach(QString meshName, m_mBoneToControlledMeshes.value(sBoneName))
+		{
+			if (controlledMeshList.contains(meshName) == false)
+				controlledMeshList.append(meshName);
+		}
+		return controlledMeshList;
+	}
+
 	for (auto childIter = pNode->nodeChildrenIterator(); childIter.hasNext(); )
 	{
 		DzFigure *childFigure = qobject_cast<DzFigure*>(childIter.next());
@@ -2207,23 +2636,14 @@ QStringList DzBridgeAction::checkMorphControlsChildren(DzNode* pNode, DzProperty
 	if (pMorphProperty == nullptr) return controlledMeshList;
 
 	controlledMeshList.append(pNode->getName() + ".Shape");
-	//int numSlaveControllers = pMorphProperty->getNumSlaveControllers();
-	for(auto iter = pMorphProperty->slaveControllerListIterator(); iter.hasNext(); )
+	foreach(int nEdgeIndex, m_MorphLinkGraph.getSlaveEdges(pMorphProperty))
 	{
-		DzController *slaveController = iter.next();
-		if (slaveController)
+		const MorphLinkEdge& edge = m_MorphLinkGraph.getEdge(nEdgeIndex);
+		if (edge.SlaveBone != "None")
 		{
-			DzProperty *ownerProperty = slaveController->getOwner();
-			if (ownerProperty)
-			{
-				DzElement* ownerElement = ownerProperty->getOwner();
-				if (ownerElement->inherits("DzBone"))
-				{
-					sBoneName = ownerElement->getName();
-					controlledMeshList = checkForBoneInChild( pNode, sBoneName, controlledMeshList );
-					break;
-				}
-			}
+			sBoneName = edge.SlaveBone;
+			controlledMeshList = checkForBoneInChild( pNode, sBoneName, controlledMeshList );
+			break;
 		}
 	}
 	if (sBoneName.isEmpty())
@@ -2240,6 +2660,14 @@ void DzBridgeAction::writeMorphLinks(DzJsonWriter& writer)
 
 	if (m_bEnableMorphs)
 	{
+		// walk the controller lists of all exported morphs once, then query the graph below
+		m_MorphLinkGraph.clear();
+		buildControlledMeshIndex(m_pSelectedNode);
+		for (QMap<QString, QString>::iterator morphNameToLabel = m_mMorphNameToLabel.begin(); morphNameToLabel != m_mMorphNameToLabel.end(); ++morphNameToLabel)
+		{
+			m_MorphLinkGraph.addProperty(m_morphSelectionDialog->GetMorphInfoFromName(morphNameToLabel.key()).Property);
+		}
+
 		// iterate through each exported morph
 		for (QMap<QString, QString>::iterator morphNameToLabel = m_mMorphNameToLabel.begin(); morphNameToLabel != m_mMorphNameToLabel.end(); ++morphNameToLabel)
 		{
@@ -2262,110 +2690,288 @@ void DzBridgeAction::writeMorphLinks(DzJsonWriter& writer)
 
 			// DB 2022-June-6: Blender JCM, Morph Controllers support
 			writer.startMemberArray("Links");
-			for (auto iterator = morphProperty->controllerListIterator(); iterator.hasNext(); )
+			foreach(int nEdgeIndex, m_MorphLinkGraph.getControllerEdges(morphProperty))
 			{
-				DzERCLink *ercLink = qobject_cast<DzERCLink*>(iterator.next());
-				if (ercLink == nullptr)
+				const MorphLinkEdge& edge = m_MorphLinkGraph.getEdge(nEdgeIndex);
+				if (edge.ControllerProperty == nullptr)
 					continue;
-				auto controllerProperty = ercLink->getProperty();
-				auto controllerOwner = controllerProperty->getOwner();
-				QString sLinkBone = "None";
-				QString sLinkProperty = controllerProperty->getName();
-				int iLinkType = ercLink->getType();
-				double fLinkScalar = ercLink->getScalar();
-				double fLinkAddend = ercLink->getAddend();
-				if (controllerOwner->inherits("DzBone"))
-				{
-					sLinkBone = controllerOwner->getName();
-					controlledMeshList = checkForBoneInChild(m_pSelectedNode, sLinkBone, controlledMeshList);
-				}
-				if (controllerOwner->inherits("DzMorph"))
+				if (edge.ControllerBone != "None")
 				{
-					sLinkProperty = controllerOwner->getName();
+					controlledMeshList = checkForBoneInChild(m_pSelectedNode, edge.ControllerBone, controlledMeshList);
 				}
 				writer.startObject();
-				writer.addMember("Bone", sLinkBone);
-				writer.addMember("Property", sLinkProperty);
-				writer.addMember("Type", iLinkType);
-				writer.addMember("Scalar", fLinkScalar);
-				writer.addMember("Addend", fLinkAddend);
-				if (iLinkType == 6)
+				writer.addMember("Bone", edge.ControllerBone);
+				writer.addMember("Property", edge.ControllerName);
+				writer.addMember("Type", edge.Type);
+				writer.addMember("Scalar", edge.Scalar);
+				writer.addMember("Addend", edge.Addend);
+				if (edge.Type == 6)
 				{
 					// Keys
-					int iKeyType = ercLink->getKeyInterpolation();
-					writer.addMember("Key Type", iKeyType);
+					writer.addMember("Key Type", edge.KeyInterpolation);
 					writer.startMemberObject("Keys");
-					for (int key_index = 0; key_index < ercLink->getNumKeyValues(); key_index++)
+					for (int key_index = 0; key_index < edge.Keys.count(); key_index++)
 					{
 						QString sKeyDataLabel = QString("Key %1").arg(key_index);
-						double fKeyDataRotate = ercLink->getKey(key_index);
-						double fKeyDataValue = ercLink->getKeyValue(key_index);
 						writer.startMemberObject(sKeyDataLabel);
-						writer.addMember("Rotate", fKeyDataRotate);
-						writer.addMember("Value", fKeyDataValue);
+						writer.addMember("Rotate", edge.Keys[key_index]);
+						writer.addMember("Value", edge.KeyValues[key_index]);
 						writer.finishObject();
 					}
 					writer.finishObject();
+					double fMin, fMax;
+					if (edge.ControllerBone != "None" && DzBridgeMorphLinkGraph::getKeyCurveRange(edge.ControllerProperty, edge.Keys, fMin, fMax))
+					{
+						writeKeyCurveLookupTable(writer, edge.Keys, edge.KeyValues, edge.KeyInterpolation, fMin, fMax);
+					}
 				}
 				writer.finishObject();
 			}
 			writer.finishArray();
 
-			writer.startMemberArray("SubLinks");
-			for (auto iterator = morphProperty->slaveControllerListIterator(); iterator.hasNext(); )
-			{
-				DzERCLink *ercLink = qobject_cast<DzERCLink*>(iterator.next());
-				if (ercLink == nullptr)
-					continue;
-				auto ercOwnerNode = ercLink->getOwner();
-				if (ercOwnerNode == nullptr)
-					continue;
-				auto ercBoneNode = ercOwnerNode->getOwner();
-				if (ercBoneNode && ercBoneNode->inherits("DzBone"))
-				{
-					QString sLinkBone = ercBoneNode->getName();
-					QString sLinkProperty = ercOwnerNode->getName();
-					int iLinkType = ercLink->getType();
-					double fLinkScalar = ercLink->getScalar();
-					double fLinkAddend = ercLink->getAddend();
-					writer.startObject();
-					writer.addMember("Bone", sLinkBone);
-					writer.addMember("Property", sLinkProperty);
-					writer.addMember("Type", iLinkType);
-					writer.addMember("Scalar", fLinkScalar);
-					writer.addMember("Addend", fLinkAddend);
-					writer.finishObject();
-				}
-			}
-			writer.finishArray();
+			writer.startMemberArray("SubLinks");
+			foreach(int nEdgeIndex, m_MorphLinkGraph.getSlaveEdges(morphProperty))
+			{
+				const MorphLinkEdge& edge = m_MorphLinkGraph.getEdge(nEdgeIndex);
+				if (edge.ERCLink == nullptr || edge.SlaveBone == "None")
+					continue;
+				writer.startObject();
+				writer.addMember("Bone", edge.SlaveBone);
+				writer.addMember("Property", edge.SlaveProperty->getName());
+				writer.addMember("Type", edge.Type);
+				writer.addMember("Scalar", edge.Scalar);
+				writer.addMember("Addend", edge.Addend);
+				writer.finishObject();
+			}
+			writer.finishArray();
+
+			double minVal = 0.0;
+			double maxVal = 1.0;
+			if (morphProperty->inherits("DzFloatProperty"))
+			{
+				minVal = qobject_cast<DzFloatProperty*>(morphProperty)->getMin();
+				maxVal = qobject_cast<DzFloatProperty*>(morphProperty)->getMax();
+			}
+			writer.addMember("Minimum", minVal);
+			writer.addMember("Maximum", maxVal);
+			bool bIsHidden = morphProperty->isHidden();
+			writer.addMember("isHidden", bIsHidden);
+			QString sMorphPath = morphInfo.Path;
+			writer.addMember("Path", sMorphPath);
+			writer.startMemberArray("Controlled Meshes");
+			// foreach mesh name
+			foreach(QString meshname, controlledMeshList)
+			{
+				writer.addItem(meshname);
+			}
+			writer.finishArray();
+
+			writer.finishObject();
+		}
+
+		m_MorphLinkGraph.clear();
+		clearControlledMeshIndex();
+	}
+
+	writer.finishObject();
+}
+
+/// <summary>
+/// Writes the geograft morphs of m_pSelectedNode to <m_sAssetName>_GeograftMorphs.bytes and adds a
+/// "GeograftMorphs" reference to the DTU.  Only active when both m_bEnableMorphs and
+/// m_bExportGeograftMorphDeltas are set; the OBJ path is run from Export() instead.
+/// </summary>
+void DzBridgeAction::writeGeograftMorphs(DzJsonWriter& writer)
+{
+	if (m_bEnableMorphs == false || m_bExportGeograftMorphDeltas == false)
+		return;
+
+	// no geograft, or none of its morphs selected for export
+	if (checkForGeograftMorphsToExport(m_pSelectedNode, false) == false)
+		return;
+
+	QString sDeltasFilename = QDir(m_sDestinationPath).filePath(m_sAssetName + "_GeograftMorphs.bytes");
+	if (exportGeograftMorphs(m_pSelectedNode, m_sDestinationPath) == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to write geograft morphs: " + sDeltasFilename);
+		return;
+	}
+
+	writer.startMemberObject("GeograftMorphs");
+	writer.addMember("File", sDeltasFilename);
+	writer.addMember("Format", QString("DZMD"));
+	writer.addMember("Quantized", m_bQuantizeMorphDeltas);
+	writer.finishObject();
+}
+
+/// <summary>
+/// Writes the deltas of all exported DzMorph modifiers of m_pSelectedNode and its child figures to
+/// <m_sAssetName>_MorphDeltas.bytes and adds a "MorphDeltas" reference to the DTU.
+/// Only active when both m_bEnableMorphs and m_bExportMorphDeltas are set.
+/// </summary>
+void DzBridgeAction::writeMorphDeltas(DzJsonWriter& writer)
+{
+	if (m_bEnableMorphs == false || m_bExportMorphDeltas == false)
+		return;
+
+	QString sDeltasFilename = m_sDestinationPath + m_sAssetName + "_MorphDeltas.bytes";
+	if (exportMorphDeltas(m_pSelectedNode, sDeltasFilename) == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to write morph deltas: " + sDeltasFilename);
+		return;
+	}
+
+	writer.startMemberObject("MorphDeltas");
+	writer.addMember("File", sDeltasFilename);
+	writer.addMember("Format", QString("DZMD"));
+	writer.addMember("Quantized", m_bQuantizeMorphDeltas);
+	writer.finishObject();
+}
+
+/// <summary>
+/// Reads the deltas of each morph in m_mMorphNameToLabel directly from the DzMorph modifiers of Node
+/// and its child figures, and writes them with DzBridgeMorphDeltaWriter.  Vertex indices are in base
+/// mesh order, the same order used for the exported mesh.  Returns false if the file could not be written.
+/// </summary>
+bool DzBridgeAction::exportMorphDeltas(DzNode* Node, QString sFilename)
+{
+	if (Node == nullptr)
+	{
+		printf("ERROR: DazBridge: DzBridgeAction.cpp, exportMorphDeltas(): nullptr passed as argument.");
+		return false;
+	}
+
+	// Daz objects are only read here on the main thread, encoding runs in parallel inside write()
+	DzBridgeMorphDeltaWriter deltaWriter(m_bQuantizeMorphDeltas);
+	foreach(DzNode* pMeshNode, getMorphDeltaMeshNodes(Node))
+	{
+		DzObject* pObject = pMeshNode->getObject();
+		DzShape* pShape = pObject ? pObject->getCurrentShape() : nullptr;
+		DzGeometry* pGeometry = pShape ? pShape->getGeometry() : nullptr;
+		if (pGeometry == nullptr)
+			continue;
+		QString sMeshName = pMeshNode->getName() + ".Shape";
+		int nVertexCount = pGeometry->getNumVertices();
+
+		for (int nModifierIndex = 0; nModifierIndex < pObject->getNumModifiers(); nModifierIndex++)
+		{
+			DzMorph* pMorph = qobject_cast<DzMorph*>(pObject->getModifier(nModifierIndex));
+			if (pMorph == nullptr || m_mMorphNameToLabel.contains(pMorph->getName()) == false)
+				continue;
+			QVector<qint32> aIndices;
+			QVector<float> aDeltas;
+			if (readMorphDeltas(pMorph, aIndices, aDeltas))
+				deltaWriter.addMorph(sMeshName, pMorph->getName(), nVertexCount, aIndices, aDeltas);
+		}
+	}
+
+	return deltaWriter.write(sFilename);
+}
+
+/// <summary>
+/// Writes a truncated PCA basis of the exported morphs to <m_sAssetName>_MorphBasis.bytes and adds a
+/// "MorphBasis" reference to the DTU.  Only active when both m_bEnableMorphs and m_bExportMorphBasis are set.
+/// </summary>
+void DzBridgeAction::writeMorphBasis(DzJsonWriter& writer)
+{
+	if (m_bEnableMorphs == false || m_bExportMorphBasis == false)
+		return;
+
+	QString sBasisFilename = m_sDestinationPath + m_sAssetName + "_MorphBasis.bytes";
+	if (exportMorphBasis(m_pSelectedNode, sBasisFilename) == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to write morph basis: " + sBasisFilename);
+		return;
+	}
 
-			double minVal = 0.0;
-			double maxVal = 1.0;
-			if (morphProperty->inherits("DzFloatProperty"))
-			{
-				minVal = qobject_cast<DzFloatProperty*>(morphProperty)->getMin();
-				maxVal = qobject_cast<DzFloatProperty*>(morphProperty)->getMax();
-			}
-			writer.addMember("Minimum", minVal);
-			writer.addMember("Maximum", maxVal);
-			bool bIsHidden = morphProperty->isHidden();
-			writer.addMember("isHidden", bIsHidden);
-			QString sMorphPath = morphInfo.Path;
-			writer.addMember("Path", sMorphPath);
-			writer.startMemberArray("Controlled Meshes");
-			// foreach mesh name
-			foreach(QString meshname, controlledMeshList)
-			{
-				writer.addItem(meshname);
-			}
-			writer.finishArray();
+	writer.startMemberObject("MorphBasis");
+	writer.addMember("File", sBasisFilename);
+	writer.addMember("Format", QString("DZMB"));
+	writer.addMember("MaxComponents", m_nMorphBasisComponents);
+	writer.finishObject();
+}
 
-			writer.finishObject();
+/// <summary>
+/// Compresses the deltas of each morph in m_mMorphNameToLabel on Node and its child figures into a PCA basis
+/// per mesh with DzBridgeMorphBasisWriter, keeping at most m_nMorphBasisComponents components per mesh
+/// (0 = as many as needed for 99.9% of the delta energy).  Returns false if the file could not be written.
+/// </summary>
+bool DzBridgeAction::exportMorphBasis(DzNode* Node, QString sFilename)
+{
+	if (Node == nullptr)
+	{
+		printf("ERROR: DazBridge: DzBridgeAction.cpp, exportMorphBasis(): nullptr passed as argument.");
+		return false;
+	}
+
+	DzBridgeMorphBasisWriter basisWriter(m_nMorphBasisComponents);
+	foreach(DzNode* pMeshNode, getMorphDeltaMeshNodes(Node))
+	{
+		DzObject* pObject = pMeshNode->getObject();
+		DzShape* pShape = pObject ? pObject->getCurrentShape() : nullptr;
+		DzGeometry* pGeometry = pShape ? pShape->getGeometry() : nullptr;
+		if (pGeometry == nullptr)
+			continue;
+		QString sMeshName = pMeshNode->getName() + ".Shape";
+		int nVertexCount = pGeometry->getNumVertices();
+
+		for (int nModifierIndex = 0; nModifierIndex < pObject->getNumModifiers(); nModifierIndex++)
+		{
+			DzMorph* pMorph = qobject_cast<DzMorph*>(pObject->getModifier(nModifierIndex));
+			if (pMorph == nullptr || m_mMorphNameToLabel.contains(pMorph->getName()) == false)
+				continue;
+			QVector<qint32> aIndices;
+			QVector<float> aDeltas;
+			if (readMorphDeltas(pMorph, aIndices, aDeltas))
+				basisWriter.addMorph(sMeshName, pMorph->getName(), nVertexCount, aIndices, aDeltas);
 		}
+	}
 
+	bool bResult = basisWriter.write(sFilename);
+	if (bResult)
+	{
+		dzApp->log(QString("DazBridge: Morph basis written: %1 morphs, largest relative error %2").arg(basisWriter.getNumMorphs()).arg(basisWriter.getMaxRelativeError()));
 	}
+	return bResult;
+}
 
-	writer.finishObject();
+// Node and its child figures, the meshes exportMorphDeltas() and exportMorphBasis() read morphs from
+DzNodeList DzBridgeAction::getMorphDeltaMeshNodes(DzNode* Node)
+{
+	DzNodeList aMeshNodes;
+	aMeshNodes.append(Node);
+	for (auto childIter = Node->nodeChildrenIterator(); childIter.hasNext(); )
+	{
+		DzFigure* childFigure = qobject_cast<DzFigure*>(childIter.next());
+		if (childFigure)
+			aMeshNodes.append(childFigure);
+	}
+	return aMeshNodes;
+}
+
+// Copies the deltas of pMorph, 3 floats per vertex index.  Returns false if the morph has no deltas.
+bool DzBridgeAction::readMorphDeltas(DzMorph* pMorph, QVector<qint32>& aIndices, QVector<float>& aDeltas)
+{
+	DzMorphDeltas* pMorphDeltas = pMorph->getDeltas();
+	if (pMorphDeltas == nullptr)
+		return false;
+
+	int nNumDeltas = pMorphDeltas->getNumDeltas();
+	const int* pIndexList = pMorphDeltas->getIndexList();
+	const DzPnt3* pDeltaList = pMorphDeltas->getDeltaList();
+	if (nNumDeltas <= 0 || pIndexList == nullptr || pDeltaList == nullptr)
+		return false;
+
+	aIndices.resize(nNumDeltas);
+	aDeltas.resize(nNumDeltas * 3);
+	for (int i = 0; i < nNumDeltas; i++)
+	{
+		aIndices[i] = pIndexList[i];
+		aDeltas[i * 3 + 0] = pDeltaList[i][0];
+		aDeltas[i * 3 + 1] = pDeltaList[i][1];
+		aDeltas[i * 3 + 2] = pDeltaList[i][2];
+	}
+	return true;
 }
 
 void DzBridgeAction::writeMorphNames(DzJsonWriter& writer)
@@ -2430,16 +3036,48 @@ void DzBridgeAction::writeMorphJointLinkInfo(DzJsonWriter& writer, const JointLi
 	writer.addMember("Alpha", linkInfo.Alpha);
 	if (linkInfo.Keys.count() > 0)
 	{
+		QVector<double> aKeys;
+		QVector<double> aKeyValues;
 		writer.startMemberArray("Keys", true);
-		foreach(JointLinkKey key, linkInfo.Keys)
+		foreach(const JointLinkKey& key, linkInfo.Keys)
 		{
 			writer.startObject(true);
-			writer.addMember("Angle", key.Angle);
-			writer.addMember("Value", key.Value);
+			writer.addMember("Angle", (int) key.Angle);
+			writer.addMember("Value", (int) key.Value);
 			writer.finishObject();
+			aKeys.append(key.Angle);
+			aKeyValues.append(key.Value);
 		}
 		writer.finishArray();
+		writeKeyCurveLookupTable(writer, aKeys, aKeyValues, linkInfo.KeyInterpolation, linkInfo.Minimum, linkInfo.Maximum);
+	}
+	writer.finishObject();
+}
+
+/// <summary>
+/// Writes a "Lookup Table" member with m_nJCMLookupTableSize samples of a keyed ERC curve, evenly spaced
+/// from fMin to fMax (both included).  The target evaluates the curve by clamping the controller value to
+/// Minimum/Maximum and reading Values[round((value - Minimum) / (Maximum - Minimum) * (count - 1))],
+/// or by interpolating between the two nearest entries.  Nothing is written when m_nJCMLookupTableSize is below 2.
+/// </summary>
+void DzBridgeAction::writeKeyCurveLookupTable(DzJsonWriter& writer, const QVector<double>& aKeys, const QVector<double>& aKeyValues, int nKeyInterpolation, double fMin, double fMax)
+{
+	if (m_nJCMLookupTableSize < 2 || fMax <= fMin)
+		return;
+
+	QVector<float> aTable;
+	if (DzBridgeMorphLinkGraph::sampleKeyCurve(aKeys, aKeyValues, nKeyInterpolation, fMin, fMax, m_nJCMLookupTableSize, aTable) == false)
+		return;
+
+	writer.startMemberObject("Lookup Table", true);
+	writer.addMember("Minimum", fMin);
+	writer.addMember("Maximum", fMax);
+	writer.startMemberArray("Values", true);
+	foreach(float fValue, aTable)
+	{
+		writer.addItem((double) fValue);
 	}
+	writer.finishArray();
 	writer.finishObject();
 }
 
@@ -3457,8 +4095,29 @@ bool DzBridgeAction::upgradeToHD(QString baseFilePath, QString hdFilePath, QStri
 		printf("\n\nAn error occurred while loading the base scene...");
 		return false;
 	}
-	SubdivideFbxScene subdivider = SubdivideFbxScene(baseMeshScene, pLookupTable);
+	SubdivideFbxScene subdivider(baseMeshScene, pLookupTable);
+	subdivider.SetSparseSkinWeights(m_bSparseSubdivisionWeights);
+	if (m_sSubdivisionCacheFolder.isEmpty() == false && QDir().mkpath(m_sSubdivisionCacheFolder))
+	{
+		subdivider.SetCacheFolder(QDir::fromNativeSeparators(m_sSubdivisionCacheFolder).toUtf8().data());
+	}
+	QElapsedTimer timer;
+	timer.start();
 	subdivider.ProcessScene();
+	for (const SubdivideFbxScene::MeshTiming& meshTiming : subdivider.GetMeshTimings())
+	{
+		dzApp->log(QString("DazBridge: Subdivided %1 to level %2: %3 -> %4 vertices in %5 ms.")
+			.arg(meshTiming.Name.c_str())
+			.arg(meshTiming.SubDLevel)
+			.arg(meshTiming.CoarseVerts)
+			.arg(meshTiming.FineVerts)
+			.arg(meshTiming.Milliseconds, 0, 'f', 1));
+	}
+	dzApp->log(QString("DazBridge: Subdivided %1 meshes in %2 ms.").arg((int) subdivider.GetMeshTimings().size()).arg(timer.elapsed()));
+	dzApp->log(QString("DazBridge: Subdivision topology cache: %1 hits, %2 misses, %3 ms saved.")
+		.arg(subdivider.GetCacheHits())
+		.arg(subdivider.GetCacheMisses())
+		.arg(subdivider.GetCacheMillisecondsSaved(), 0, 'f', 1));
 	FbxScene* hdMeshScene = openFBX->CreateScene("HD Mesh Scene");
 	if (openFBX->LoadScene(hdMeshScene, hdFilePath.toLocal8Bit().data()) == false)
 	{
@@ -4249,7 +4908,53 @@ void DzBridgeAction::resetArray_ControllersToDisconnect()
 	m_undoTable_ControllersToDisconnect.clear();
 }
 
+/// <summary>
+/// Writes all visible meshes in the scene to an OBJ file at base resolution, with the same settings
+/// the DzObjExporter path uses (no welding, unused vertices removed, no VT/VN).  The native
+/// DzBridgeObjWriter is used unless m_bUseLegacyObjExporter is set.
+/// </summary>
 bool DzBridgeAction::exportObj(QString filepath)
+{
+	if (m_bUseLegacyObjExporter)
+		return exportObjWithDzObjExporter(filepath);
+
+	DzBridgeObjWriter objWriter;
+	objWriter.setWeldSeams(false);
+	objWriter.setRemoveUnusedVerts(true);
+	objWriter.setWriteVT(false);
+	objWriter.setWriteVN(false);
+	objWriter.setFloatPrecision(6);
+	if (objWriter.open(filepath) == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to open OBJ file for writing: " + filepath);
+		return false;
+	}
+
+	DzNodeListIterator oSceneNodeIterator = dzScene->nodeListIterator();
+	while (oSceneNodeIterator.hasNext())
+	{
+		DzNode* pNode = oSceneNodeIterator.next();
+		if (pNode->isVisible() == false)
+			continue;
+		DzObject* pObject = pNode->getObject();
+		if (pObject == nullptr)
+			continue;
+		pObject->forceCacheUpdate(pNode, false);
+		DzFacetMesh* pMesh = qobject_cast<DzFacetMesh*>(pObject->getCachedGeom());
+		if (pMesh == nullptr)
+			continue;
+		objWriter.writeMesh(pMesh);
+	}
+
+	if (objWriter.close() == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to write OBJ file: " + filepath);
+		return false;
+	}
+	return true;
+}
+
+bool DzBridgeAction::exportObjWithDzObjExporter(QString filepath)
 {
 	DzExportMgr* ExportManager = dzApp->getExportMgr();
 	DzExporter* Exporter = ExportManager->findExporterByClassName("DzObjExporter");
@@ -4337,26 +5042,7 @@ bool is_faced_mesh_single(DzNode* pNode)
 bool DzBridgeAction::checkForGeograftMorphsToExport(DzNode* Node, bool bZeroMorphForExport)
 {
 	bool bGeograftMorphsFoundToExport = false;
-	DzNode* pGeograftNode = nullptr;
-	DzNode* pParentNode = Node;
-	// 1. find geograft/genital
-	DzNodeListIterator oNodeChildrenIter = Node->nodeChildrenIterator();
-	while (oNodeChildrenIter.hasNext())
-	{
-		DzNode* pChild = oNodeChildrenIter.next();
-		DzPresentation* presentation = pChild->getPresentation();
-		if (presentation)
-		{
-			const QString presentationType = presentation->getType();
-			if (pChild->getName().toLower().contains("genital") ||
-				presentationType == "Follower/Attachment/Lower-Body/Hip/Front" ||
-				presentationType == "Follower/Attachment/Lower-Body")
-			{
-				pGeograftNode = pChild;
-				break;
-			}
-		}
-	}
+	DzNode* pGeograftNode = findGeograftNode(Node);
 	if (pGeograftNode == nullptr)
 	{
 		return false;
@@ -4412,55 +5098,21 @@ bool DzBridgeAction::checkForGeograftMorphsToExport(DzNode* Node, bool bZeroMorp
 	return bGeograftMorphsFoundToExport;
 }
 
+/// <summary>
+/// Exports each geograft morph found by checkForGeograftMorphsToExport().  By default one OBJ is
+/// exported per morph.  With m_bExportGeograftMorphDeltas, the parent figure and geograft meshes are
+/// read once per morph from the object cache and all deltas are written to a single
+/// <m_sAssetName>_GeograftMorphs.bytes file (DzBridgeMorphDeltaWriter format); scene visibility
+/// is not touched.
+/// </summary>
 bool DzBridgeAction::exportGeograftMorphs(DzNode *Node, QString sDestinationFolder)
 {
-	DzNode *pGeograftNode = nullptr;
+	DzNode *pGeograftNode = findGeograftNode(Node);
 	DzNode *pParentNode = Node;
-	// 1. find geograft/genital
-	DzNodeListIterator oNodeChildrenIter = Node->nodeChildrenIterator();
-	while (oNodeChildrenIter.hasNext())
-	{
-		DzNode* pChild = oNodeChildrenIter.next();
-		DzPresentation* presentation = pChild->getPresentation();
-		if (presentation)
-		{
-			const QString presentationType = presentation->getType();
-			if (pChild->getName().toLower().contains("genital") ||
-				presentationType == "Follower/Attachment/Lower-Body/Hip/Front" ||
-				presentationType == "Follower/Attachment/Lower-Body")
-			{
-				pGeograftNode = pChild;
-				break;
-			}
-		}
-	}
 	if (pGeograftNode == nullptr)
 	{
 		return false;
 	}
-	// Hide everything
-	QList<QPair<DzNode*, bool>> oUndoList_for_NodeVisibility;
-	DzNodeListIterator oSceneNodeIterator = dzScene->nodeListIterator();
-	while (oSceneNodeIterator.hasNext())
-	{
-		DzNode* pNode = oSceneNodeIterator.next();
-		oUndoList_for_NodeVisibility.append(QPair<DzNode*, bool>(pNode, pNode->isVisible()));
-		if (pNode == pParentNode || pNode == pGeograftNode)
-		{
-			pNode->setVisible(true);
-		}
-		else if (pNode->getNodeParent() == pParentNode)
-		{
-			pNode->setVisible(false);
-		}
-		else
-		{
-			if (is_faced_mesh_single(pNode) != false)
-				pNode->setVisible(false);
-		}
-	}
-//	pGeograftNode->setVisible(true);
-//	pParentNode->setVisible(true);
 
 	// set all morphs to zero
 	// add morphs to TODO list for exporting
@@ -4508,8 +5160,100 @@ bool DzBridgeAction::exportGeograftMorphs(DzNode *Node, QString sDestinationFold
 			}
 		}
 	}
-	// for each morph,
+
+	if (m_bExportGeograftMorphDeltas == false)
+	{
+		return exportGeograftMorphsAsObj(pParentNode, pGeograftNode, oGeograftMorphsToExport, sDestinationFolder);
+	}
+
+	// read base positions once, then only the positions of each morph at 1.0
+	DzNodeList aMeshNodes;
+	aMeshNodes.append(pParentNode);
+	aMeshNodes.append(pGeograftNode);
+	QList<QVector<float>> aBasePositions;
+	foreach(DzNode* pMeshNode, aMeshNodes)
+	{
+		QVector<float> aPositions;
+		readCachedVertexPositions(pMeshNode, aPositions);
+		aBasePositions.append(aPositions);
+	}
+
+	DzBridgeMorphDeltaWriter deltaWriter(m_bQuantizeMorphDeltas);
 	foreach(auto morphPair, oGeograftMorphsToExport)
+	{
+		QString sMorphName = morphPair.first;
+		DzNumericProperty* pNumericProperty = morphPair.second;
+		pNumericProperty->setDoubleValue(1.0);
+		for (int nMeshIndex = 0; nMeshIndex < aMeshNodes.count(); nMeshIndex++)
+		{
+			const QVector<float>& aBase = aBasePositions[nMeshIndex];
+			QVector<float> aPositions;
+			int nVertexCount = readCachedVertexPositions(aMeshNodes[nMeshIndex], aPositions);
+			if (nVertexCount == 0 || aPositions.count() != aBase.count())
+				continue;
+
+			QVector<qint32> aIndices;
+			QVector<float> aDeltas;
+			for (int nVertex = 0; nVertex < nVertexCount; nVertex++)
+			{
+				float x = aPositions[nVertex * 3 + 0] - aBase[nVertex * 3 + 0];
+				float y = aPositions[nVertex * 3 + 1] - aBase[nVertex * 3 + 1];
+				float z = aPositions[nVertex * 3 + 2] - aBase[nVertex * 3 + 2];
+				if (x == 0.0f && y == 0.0f && z == 0.0f)
+					continue;
+				aIndices.append(nVertex);
+				aDeltas.append(x);
+				aDeltas.append(y);
+				aDeltas.append(z);
+			}
+			if (aIndices.isEmpty() == false)
+				deltaWriter.addMorph(aMeshNodes[nMeshIndex]->getName() + ".Shape", sMorphName, nVertexCount, aIndices, aDeltas);
+		}
+		pNumericProperty->setDoubleValue(0);
+	}
+
+	QString sDeltasFilename = QDir(sDestinationFolder).filePath(m_sAssetName + "_GeograftMorphs.bytes");
+	if (deltaWriter.write(sDeltasFilename) == false)
+	{
+		dzApp->log("DazBridge: ERROR Unable to write geograft morphs: " + sDeltasFilename);
+		return false;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Legacy geograft morph export: hides everything except the parent figure and geograft, then runs
+/// a full OBJ export for each morph set to 1.0.  Visibility is restored afterwards.
+/// </summary>
+bool DzBridgeAction::exportGeograftMorphsAsObj(DzNode* pParentNode, DzNode* pGeograftNode, const QList<QPair<QString, DzNumericProperty*>>& aGeograftMorphs, QString sDestinationFolder)
+{
+	// Hide everything
+	QList<QPair<DzNode*, bool>> oUndoList_for_NodeVisibility;
+	DzNodeListIterator oSceneNodeIterator = dzScene->nodeListIterator();
+	while (oSceneNodeIterator.hasNext())
+	{
+		DzNode* pNode = oSceneNodeIterator.next();
+		oUndoList_for_NodeVisibility.append(QPair<DzNode*, bool>(pNode, pNode->isVisible()));
+		if (pNode == pParentNode || pNode == pGeograftNode)
+		{
+			pNode->setVisible(true);
+		}
+		else if (pNode->getNodeParent() == pParentNode)
+		{
+			pNode->setVisible(false);
+		}
+		else
+		{
+			if (is_faced_mesh_single(pNode) != false)
+				pNode->setVisible(false);
+		}
+	}
+//	pGeograftNode->setVisible(true);
+//	pParentNode->setVisible(true);
+
+	// for each morph,
+	foreach(auto morphPair, aGeograftMorphs)
 	{
 		QString sMorphName = morphPair.first;
 		DzNumericProperty* pNumericProperty = morphPair.second;
@@ -4531,4 +5275,62 @@ bool DzBridgeAction::exportGeograftMorphs(DzNode *Node, QString sDestinationFold
 	return true;
 }
 
+/// <summary>
+/// Updates the object cache of pNode (without SubD) and copies its vertex positions into aPositions,
+/// 3 floats per vertex.  Returns the vertex count, or 0 if the node has no cached mesh.
+/// </summary>
+int DzBridgeAction::readCachedVertexPositions(DzNode* pNode, QVector<float>& aPositions)
+{
+	aPositions.clear();
+	DzObject* pObject = pNode ? pNode->getObject() : nullptr;
+	if (pObject == nullptr)
+		return 0;
+
+	pObject->forceCacheUpdate(pNode, false);
+	DzVertexMesh* pMesh = pObject->getCachedGeom();
+	if (pMesh == nullptr)
+		return 0;
+
+	int nVertexCount = pMesh->getNumVertices();
+	const DzPnt3* pVertices = pMesh->getVertexArray();
+	if (pVertices == nullptr)
+		return 0;
+
+	aPositions.resize(nVertexCount * 3);
+	for (int nVertex = 0; nVertex < nVertexCount; nVertex++)
+	{
+		aPositions[nVertex * 3 + 0] = pVertices[nVertex][0];
+		aPositions[nVertex * 3 + 1] = pVertices[nVertex][1];
+		aPositions[nVertex * 3 + 2] = pVertices[nVertex][2];
+	}
+	return nVertexCount;
+}
+
+/// <summary>
+/// Returns the geograft (genital) follower of Node, or nullptr if there is none.
+/// </summary>
+DzNode* DzBridgeAction::findGeograftNode(DzNode* Node)
+{
+	if (Node == nullptr)
+		return nullptr;
+
+	DzNodeListIterator oNodeChildrenIter = Node->nodeChildrenIterator();
+	while (oNodeChildrenIter.hasNext())
+	{
+		DzNode* pChild = oNodeChildrenIter.next();
+		DzPresentation* presentation = pChild->getPresentation();
+		if (presentation)
+		{
+			const QString presentationType = presentation->getType();
+			if (pChild->getName().toLower().contains("genital") ||
+				presentationType == "Follower/Attachment/Lower-Body/Hip/Front" ||
+				presentationType == "Follower/Attachment/Lower-Body")
+			{
+				return pChild;
+			}
+		}
+	}
+	return nullptr;
+}
+
 #include "moc_DzBridgeAction.cpp"
@@ -3,6 +3,7 @@
 #include <QtNetwork/qudpsocket.h>
 #include <QtNetwork/qabstractsocket.h>
 #include <QUuid.h>
+#include <QtCore/qfileinfo.h>
 
 #include <dzapp.h>
 #include <dzscene.h>
@@ -133,9 +134,10 @@ void DzBridgeAction::executeAction()
 void DzBridgeAction::writeConfiguration()
 {
 	 QString DTUfilename = m_sDestinationPath + m_sExportFilename + ".dtu";
-	 QFile DTUfile(DTUfilename);
-	 DTUfile.open(QIODevice::WriteOnly);
-	 DzJsonWriter writer(&DTUfile);
+	 QIODevice* pDTUfile = openDtuFile(DTUfilename);
+	 if (pDTUfile == nullptr)
+		 return;
+	 DzJsonWriter writer(pDTUfile);
 	 writer.startObject(true);
 
 	 writeDTUHeader(writer);
@@ -143,21 +145,28 @@ void DzBridgeAction::writeConfiguration()
 	 if (m_sAssetType.toLower().contains("mesh") || m_sAssetType == "Animation")
 	 {
 		 QTextStream *pCVSStream = nullptr;
+		 QFile CSVfile(m_sDestinationPath + m_sAssetName + "_Maps.csv");
 		 if (m_bExportMaterialPropertiesCSV)
 		 {
-			 QString filename = m_sDestinationPath + m_sAssetName + "_Maps.csv";
-			 QFile file(filename);
-			 file.open(QIODevice::WriteOnly);
-			 pCVSStream = new QTextStream(&file);
-			 *pCVSStream << "Version, Object, Material, Type, Color, Opacity, File" << endl;
+			 CSVfile.open(QIODevice::WriteOnly);
+			 pCVSStream = new QTextStream(&CSVfile);
+			 *pCVSStream << "Version, Object, Material, Type, Color, Opacity, File" << "\n";
 		 }
 		 writeAllMaterials(m_pSelectedNode, writer, pCVSStream);
+		 if (pCVSStream)
+		 {
+			 delete pCVSStream;
+			 CSVfile.close();
+		 }
 		 writeAllMorphs(writer);
 
 		 writeMorphLinks(writer);
 		 //writer.startMemberObject("MorphLinks");
 		 //writer.finishObject();
 		 writeMorphNames(writer);
+		 writeMorphDeltas(writer);
+		 writeMorphBasis(writer);
+		 writeGeograftMorphs(writer);
 		 //writer.startMemberArray("MorphNames");
 		 //writer.finishArray();
 
@@ -184,7 +193,13 @@ void DzBridgeAction::writeConfiguration()
 	 }
 
 	 writer.finishObject();
-	 DTUfile.close();
+	 pDTUfile->close();
+	 delete pDTUfile;
+
+	 if (m_bUseMaterialTemplates)
+	 {
+		 dzApp->log(QString("DazBridge: DTU file written with Material Templates: %1 (%2 bytes)").arg(DTUfilename).arg(QFileInfo(DTUfilename).size()));
+	 }
 
 }
 
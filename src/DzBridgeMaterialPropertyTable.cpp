@@ -0,0 +1,151 @@
+#include <QtCore/qfile.h>
+#include <QtCore/qdatastream.h>
+#include <string.h>
+
+#include "DzBridgeMaterialPropertyTable.h"
+
+using namespace DzBridgeNameSpace;
+
+DzBridgeMaterialPropertyTable::DzBridgeMaterialPropertyTable()
+{
+	clear();
+}
+
+void DzBridgeMaterialPropertyTable::clear()
+{
+	m_aStrings.clear();
+	m_mStringIndex.clear();
+	m_aVersion.clear();
+	m_aObject.clear();
+	m_aMaterial.clear();
+	m_aShader.clear();
+	m_aProperty.clear();
+	m_aStringValue.clear();
+	m_aNumericValue.clear();
+	m_aDataType.clear();
+	m_aTexture.clear();
+}
+
+quint32 DzBridgeMaterialPropertyTable::getStringIndex(const QString& sValue)
+{
+	QHash<QString, quint32>::const_iterator result = m_mStringIndex.constFind(sValue);
+	if (result != m_mStringIndex.constEnd())
+		return result.value();
+
+	quint32 nIndex = (quint32) m_aStrings.count();
+	m_aStrings.append(sValue);
+	m_mStringIndex.insert(sValue, nIndex);
+
+	return nIndex;
+}
+
+void DzBridgeMaterialPropertyTable::addKeyColumns(int nVersion, const QString& sObject, const QString& sMaterial, const QString& sShader,
+	const QString& sProperty, const QString& sDataType, const QString& sTexture)
+{
+	m_aVersion.append(nVersion);
+	m_aObject.append(getStringIndex(sObject));
+	m_aMaterial.append(getStringIndex(sMaterial));
+	m_aShader.append(getStringIndex(sShader));
+	m_aProperty.append(getStringIndex(sProperty));
+	m_aDataType.append(getStringIndex(sDataType));
+	m_aTexture.append(getStringIndex(sTexture));
+}
+
+void DzBridgeMaterialPropertyTable::addRow(int nVersion, const QString& sObject, const QString& sMaterial, const QString& sShader,
+	const QString& sProperty, const QString& sValue, const QString& sDataType, const QString& sTexture)
+{
+	addKeyColumns(nVersion, sObject, sMaterial, sShader, sProperty, sDataType, sTexture);
+	m_aStringValue.append(getStringIndex(sValue));
+	m_aNumericValue.append(0.0);
+}
+
+void DzBridgeMaterialPropertyTable::addRow(int nVersion, const QString& sObject, const QString& sMaterial, const QString& sShader,
+	const QString& sProperty, double dValue, const QString& sDataType, const QString& sTexture)
+{
+	addKeyColumns(nVersion, sObject, sMaterial, sShader, sProperty, sDataType, sTexture);
+	m_aStringValue.append(s_nNoString);
+	m_aNumericValue.append(dValue);
+}
+
+void DzBridgeMaterialPropertyTable::writeCSV(QTextStream& stream, int nBlockRows) const
+{
+	const QString sSeparator(", ");
+	QString sBlock;
+	int nRowsInBlock = 0;
+	for (int i = 0; i < m_aVersion.count(); i++)
+	{
+		sBlock += QString::number(m_aVersion[i]) + sSeparator +
+			m_aStrings[m_aObject[i]] + sSeparator +
+			m_aStrings[m_aMaterial[i]] + sSeparator +
+			m_aStrings[m_aShader[i]] + sSeparator +
+			m_aStrings[m_aProperty[i]] + sSeparator;
+		if (m_aStringValue[i] == s_nNoString)
+			sBlock += QString::number(m_aNumericValue[i]);
+		else
+			sBlock += m_aStrings[m_aStringValue[i]];
+		sBlock += sSeparator + m_aStrings[m_aDataType[i]] + sSeparator + m_aStrings[m_aTexture[i]] + "\n";
+
+		if (++nRowsInBlock >= nBlockRows)
+		{
+			stream << sBlock;
+			sBlock.clear();
+			nRowsInBlock = 0;
+		}
+	}
+	if (sBlock.isEmpty() == false)
+	{
+		stream << sBlock;
+	}
+	stream.flush();
+
+}
+
+bool DzBridgeMaterialPropertyTable::writeBinary(const QString& sFilename) const
+{
+	QFile file(sFilename);
+	if (file.open(QIODevice::WriteOnly) == false)
+		return false;
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+	stream.writeRawData("DZMP", 4);
+	stream << (quint32) 1;
+	stream << (quint32) m_aVersion.count();
+
+	stream << (quint32) m_aStrings.count();
+	foreach(QString sValue, m_aStrings)
+	{
+		QByteArray utf8 = sValue.toUtf8();
+		stream << (quint32) utf8.size();
+		stream.writeRawData(utf8.constData(), utf8.size());
+	}
+
+	const char* aColumnNames[] = { "Version", "Object", "Material", "Type", "Property", "Value", "Numeric Value", "Data Type", "Texture" };
+	const quint8 aColumnTypes[] = { ColumnType_Int32, ColumnType_String, ColumnType_String, ColumnType_String, ColumnType_String,
+		ColumnType_String, ColumnType_Double, ColumnType_String, ColumnType_String };
+	const int nNumColumns = sizeof(aColumnTypes) / sizeof(aColumnTypes[0]);
+	stream << (quint32) nNumColumns;
+	for (int i = 0; i < nNumColumns; i++)
+	{
+		stream << (quint32) strlen(aColumnNames[i]);
+		stream.writeRawData(aColumnNames[i], (int) strlen(aColumnNames[i]));
+		stream << aColumnTypes[i];
+	}
+
+	foreach(qint32 nValue, m_aVersion) stream << nValue;
+	foreach(quint32 nValue, m_aObject) stream << nValue;
+	foreach(quint32 nValue, m_aMaterial) stream << nValue;
+	foreach(quint32 nValue, m_aShader) stream << nValue;
+	foreach(quint32 nValue, m_aProperty) stream << nValue;
+	foreach(quint32 nValue, m_aStringValue) stream << nValue;
+	foreach(double dValue, m_aNumericValue) stream << dValue;
+	foreach(quint32 nValue, m_aDataType) stream << nValue;
+	foreach(quint32 nValue, m_aTexture) stream << nValue;
+
+	bool bResult = (stream.status() == QDataStream::Ok);
+	file.close();
+
+	return bResult;
+}
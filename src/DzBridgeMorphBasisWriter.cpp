@@ -0,0 +1,318 @@
+#include <QtCore/qfile.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qtconcurrentmap.h>
+#include <algorithm>
+#include <math.h>
+
+#include "DzBridgeMorphBasisWriter.h"
+
+using namespace DzBridgeNameSpace;
+
+DzBridgeMorphBasisWriter::DzBridgeMorphBasisWriter(int nMaxComponents, float fEnergyKept)
+{
+	m_nMaxComponents = nMaxComponents;
+	m_fEnergyKept = fEnergyKept;
+	m_fMaxRelativeError = 0.0f;
+}
+
+void DzBridgeMorphBasisWriter::clear()
+{
+	m_aMorphs.clear();
+	m_aMeshes.clear();
+	m_fMaxRelativeError = 0.0f;
+}
+
+void DzBridgeMorphBasisWriter::addMorph(const QString& sMeshName, const QString& sMorphName, int nVertexCount,
+	const QVector<qint32>& aIndices, const QVector<float>& aDeltas)
+{
+	MorphRecord record;
+	record.MeshName = sMeshName;
+	record.MorphName = sMorphName;
+	record.VertexCount = nVertexCount;
+	record.Indices = aIndices;
+	record.Deltas = aDeltas;
+	m_aMorphs.append(record);
+}
+
+int DzBridgeMorphBasisWriter::getNumComponents(const QString& sMeshName) const
+{
+	foreach(const MeshBasis& meshBasis, m_aMeshes)
+	{
+		if (meshBasis.MeshName == sMeshName)
+			return meshBasis.Variance.count();
+	}
+	return 0;
+}
+
+void DzBridgeMorphBasisWriter::jacobiEigen(double* pMatrix, int n, double* pEigenvalues, double* pEigenvectors)
+{
+	double* a = pMatrix;
+	double* v = pEigenvectors;
+	for (int i = 0; i < n * n; i++)
+		v[i] = 0.0;
+	double dNorm = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		v[i * n + i] = 1.0;
+		for (int j = 0; j < n; j++)
+			dNorm += a[i * n + j] * a[i * n + j];
+	}
+
+	for (int nSweep = 0; nSweep < 100; nSweep++)
+	{
+		double dOffDiagonal = 0.0;
+		for (int p = 0; p < n; p++)
+			for (int q = p + 1; q < n; q++)
+				dOffDiagonal += a[p * n + q] * a[p * n + q];
+		if (dOffDiagonal <= 1e-24 * dNorm)
+			break;
+
+		for (int p = 0; p < n - 1; p++)
+		{
+			for (int q = p + 1; q < n; q++)
+			{
+				double apq = a[p * n + q];
+				if (apq == 0.0)
+					continue;
+				double app = a[p * n + p];
+				double aqq = a[q * n + q];
+				double theta = (aqq - app) / (2.0 * apq);
+				double t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+				double c = 1.0 / sqrt(t * t + 1.0);
+				double s = t * c;
+
+				for (int k = 0; k < n; k++)
+				{
+					if (k == p || k == q)
+						continue;
+					double akp = a[k * n + p];
+					double akq = a[k * n + q];
+					a[k * n + p] = a[p * n + k] = c * akp - s * akq;
+					a[k * n + q] = a[q * n + k] = s * akp + c * akq;
+				}
+				a[p * n + p] = app - t * apq;
+				a[q * n + q] = aqq + t * apq;
+				a[p * n + q] = a[q * n + p] = 0.0;
+
+				for (int k = 0; k < n; k++)
+				{
+					double vkp = v[k * n + p];
+					double vkq = v[k * n + q];
+					v[k * n + p] = c * vkp - s * vkq;
+					v[k * n + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < n; i++)
+		pEigenvalues[i] = a[i * n + i];
+}
+
+void DzBridgeMorphBasisWriter::computeMeshBasis(MeshBasis& meshBasis, const QList<int>& aMorphIndices) const
+{
+	int nNumMorphs = aMorphIndices.count();
+
+	// union of all moved vertices, in ascending order
+	QVector<qint32> aVertices;
+	foreach(int nMorph, aMorphIndices)
+		aVertices += m_aMorphs[nMorph].Indices;
+	std::sort(aVertices.begin(), aVertices.end());
+	aVertices.erase(std::unique(aVertices.begin(), aVertices.end()), aVertices.end());
+	meshBasis.Vertices = aVertices;
+	int nDimension = aVertices.count() * 3;
+
+	// dense delta matrix, one row per morph
+	QVector<float> aRows(nNumMorphs * nDimension, 0.0f);
+	for (int m = 0; m < nNumMorphs; m++)
+	{
+		const MorphRecord& record = m_aMorphs[aMorphIndices[m]];
+		meshBasis.MorphNames.append(record.MorphName);
+		float* pRow = aRows.data() + m * nDimension;
+		int nNumDeltas = qMin(record.Indices.count(), record.Deltas.count() / 3);
+		for (int i = 0; i < nNumDeltas; i++)
+		{
+			int nColumn = int(std::lower_bound(aVertices.constBegin(), aVertices.constEnd(), record.Indices[i]) - aVertices.constBegin()) * 3;
+			pRow[nColumn + 0] = record.Deltas[i * 3 + 0];
+			pRow[nColumn + 1] = record.Deltas[i * 3 + 1];
+			pRow[nColumn + 2] = record.Deltas[i * 3 + 2];
+		}
+	}
+
+	// Gram matrix, each task fills row m from the diagonal on (and the mirrored column)
+	QVector<double> aGram(nNumMorphs * nNumMorphs, 0.0);
+	QVector<int> aTasks(nNumMorphs);
+	for (int m = 0; m < nNumMorphs; m++)
+		aTasks[m] = m;
+	const float* pRows = aRows.constData();
+	double* pGram = aGram.data();
+	QtConcurrent::blockingMap(aTasks, [pRows, pGram, nNumMorphs, nDimension](int& m) {
+		const float* pRowM = pRows + m * nDimension;
+		for (int j = m; j < nNumMorphs; j++)
+		{
+			const float* pRowJ = pRows + j * nDimension;
+			double dDot = 0.0;
+			for (int i = 0; i < nDimension; i++)
+				dDot += double(pRowM[i]) * double(pRowJ[i]);
+			pGram[m * nNumMorphs + j] = dDot;
+			pGram[j * nNumMorphs + m] = dDot;
+		}
+	});
+
+	QVector<double> aSquaredNorms(nNumMorphs);
+	double dTotalEnergy = 0.0;
+	for (int m = 0; m < nNumMorphs; m++)
+	{
+		aSquaredNorms[m] = aGram[m * nNumMorphs + m];
+		dTotalEnergy += aSquaredNorms[m];
+	}
+
+	QVector<double> aEigenvalues(nNumMorphs);
+	QVector<double> aEigenvectors(nNumMorphs * nNumMorphs);
+	jacobiEigen(aGram.data(), nNumMorphs, aEigenvalues.data(), aEigenvectors.data());
+
+	// largest components first, keep enough of them for the requested energy
+	QVector<int> aOrder(nNumMorphs);
+	for (int i = 0; i < nNumMorphs; i++)
+		aOrder[i] = i;
+	std::sort(aOrder.begin(), aOrder.end(), [&aEigenvalues](int a, int b) { return aEigenvalues[a] > aEigenvalues[b]; });
+
+	int nNumComponents = 0;
+	double dKeptEnergy = 0.0;
+	while (nNumComponents < nNumMorphs && dKeptEnergy < m_fEnergyKept * dTotalEnergy)
+	{
+		if (m_nMaxComponents > 0 && nNumComponents >= m_nMaxComponents)
+			break;
+		double dEigenvalue = aEigenvalues[aOrder[nNumComponents]];
+		if (dEigenvalue <= 1e-12 * dTotalEnergy)
+			break;
+		dKeptEnergy += dEigenvalue;
+		nNumComponents++;
+	}
+
+	// basis vector k = (sum_m u_k[m] * row_m) / sqrt(lambda_k), computed per component in parallel
+	meshBasis.Variance.resize(nNumComponents);
+	meshBasis.Basis.fill(0.0f, nNumComponents * nDimension);
+	QVector<int> aComponentTasks(nNumComponents);
+	for (int k = 0; k < nNumComponents; k++)
+	{
+		aComponentTasks[k] = k;
+		meshBasis.Variance[k] = float(aEigenvalues[aOrder[k]]);
+	}
+	const double* pEigenvectors = aEigenvectors.constData();
+	const double* pEigenvalues = aEigenvalues.constData();
+	const int* pOrder = aOrder.constData();
+	float* pBasis = meshBasis.Basis.data();
+	QtConcurrent::blockingMap(aComponentTasks, [pRows, pBasis, pEigenvectors, pEigenvalues, pOrder, nNumMorphs, nDimension](int& k) {
+		int nEigen = pOrder[k];
+		double dScale = 1.0 / sqrt(pEigenvalues[nEigen]);
+		QVector<double> aVector(nDimension, 0.0);
+		for (int m = 0; m < nNumMorphs; m++)
+		{
+			double dWeight = pEigenvectors[m * nNumMorphs + nEigen];
+			const float* pRow = pRows + m * nDimension;
+			for (int i = 0; i < nDimension; i++)
+				aVector[i] += dWeight * pRow[i];
+		}
+		float* pVector = pBasis + k * nDimension;
+		for (int i = 0; i < nDimension; i++)
+			pVector[i] = float(aVector[i] * dScale);
+	});
+
+	// coefficient of morph m on component k is sqrt(lambda_k) * u_k[m], the basis is orthonormal
+	// so the squared reconstruction error is what the kept coefficients do not cover
+	meshBasis.Coefficients.resize(nNumMorphs * nNumComponents);
+	meshBasis.RMSError.resize(nNumMorphs);
+	meshBasis.RelativeError.resize(nNumMorphs);
+	int nNumBasisVertices = qMax(1, aVertices.count());
+	for (int m = 0; m < nNumMorphs; m++)
+	{
+		double dCovered = 0.0;
+		for (int k = 0; k < nNumComponents; k++)
+		{
+			int nEigen = aOrder[k];
+			double dCoefficient = sqrt(aEigenvalues[nEigen]) * aEigenvectors[m * nNumMorphs + nEigen];
+			meshBasis.Coefficients[m * nNumComponents + k] = float(dCoefficient);
+			dCovered += dCoefficient * dCoefficient;
+		}
+		double dResidual = qMax(0.0, aSquaredNorms[m] - dCovered);
+		meshBasis.RMSError[m] = float(sqrt(dResidual / nNumBasisVertices));
+		meshBasis.RelativeError[m] = (aSquaredNorms[m] > 0.0) ? float(sqrt(dResidual / aSquaredNorms[m])) : 0.0f;
+	}
+}
+
+bool DzBridgeMorphBasisWriter::write(const QString& sFilename)
+{
+	// group morphs by mesh, keeping the order meshes were first added in
+	QStringList aMeshNames;
+	QList<QList<int>> aMeshMorphs;
+	for (int nMorph = 0; nMorph < m_aMorphs.count(); nMorph++)
+	{
+		int nMesh = aMeshNames.indexOf(m_aMorphs[nMorph].MeshName);
+		if (nMesh < 0)
+		{
+			nMesh = aMeshNames.count();
+			aMeshNames.append(m_aMorphs[nMorph].MeshName);
+			aMeshMorphs.append(QList<int>());
+		}
+		aMeshMorphs[nMesh].append(nMorph);
+	}
+
+	m_aMeshes.clear();
+	m_fMaxRelativeError = 0.0f;
+	for (int nMesh = 0; nMesh < aMeshNames.count(); nMesh++)
+	{
+		MeshBasis meshBasis;
+		meshBasis.MeshName = aMeshNames[nMesh];
+		meshBasis.VertexCount = m_aMorphs[aMeshMorphs[nMesh].first()].VertexCount;
+		computeMeshBasis(meshBasis, aMeshMorphs[nMesh]);
+		foreach(float fError, meshBasis.RelativeError)
+			m_fMaxRelativeError = qMax(m_fMaxRelativeError, fError);
+		m_aMeshes.append(meshBasis);
+	}
+
+	QFile file(sFilename);
+	if (file.open(QIODevice::WriteOnly) == false)
+		return false;
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+	stream.writeRawData("DZMB", 4);
+	stream << (quint32) 1;
+	stream << (quint32) m_aMeshes.count();
+
+	foreach(const MeshBasis& meshBasis, m_aMeshes)
+	{
+		QByteArray utf8 = meshBasis.MeshName.toUtf8();
+		stream << (quint32) utf8.size();
+		stream.writeRawData(utf8.constData(), utf8.size());
+		stream << (quint32) meshBasis.VertexCount;
+
+		stream << (quint32) meshBasis.Vertices.count();
+		foreach(qint32 nIndex, meshBasis.Vertices) stream << nIndex;
+
+		stream << (quint32) meshBasis.Variance.count();
+		foreach(float fValue, meshBasis.Variance) stream << fValue;
+		foreach(float fValue, meshBasis.Basis) stream << fValue;
+
+		int nNumComponents = meshBasis.Variance.count();
+		stream << (quint32) meshBasis.MorphNames.count();
+		for (int m = 0; m < meshBasis.MorphNames.count(); m++)
+		{
+			utf8 = meshBasis.MorphNames[m].toUtf8();
+			stream << (quint32) utf8.size();
+			stream.writeRawData(utf8.constData(), utf8.size());
+			for (int k = 0; k < nNumComponents; k++)
+				stream << meshBasis.Coefficients[m * nNumComponents + k];
+			stream << meshBasis.RMSError[m];
+			stream << meshBasis.RelativeError[m];
+		}
+	}
+
+	bool bResult = (stream.status() == QDataStream::Ok);
+	file.close();
+
+	return bResult;
+}
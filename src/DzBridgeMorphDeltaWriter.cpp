@@ -0,0 +1,134 @@
+#include <QtCore/qfile.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qtconcurrentmap.h>
+#include <algorithm>
+#include <math.h>
+
+#include "DzBridgeMorphDeltaWriter.h"
+
+using namespace DzBridgeNameSpace;
+
+DzBridgeMorphDeltaWriter::DzBridgeMorphDeltaWriter(bool bQuantize, float fThreshold)
+{
+	m_bQuantize = bQuantize;
+	m_fThreshold = fThreshold;
+}
+
+void DzBridgeMorphDeltaWriter::clear()
+{
+	m_aMorphs.clear();
+}
+
+void DzBridgeMorphDeltaWriter::addMorph(const QString& sMeshName, const QString& sMorphName, int nVertexCount,
+	const QVector<qint32>& aIndices, const QVector<float>& aDeltas)
+{
+	MorphRecord record;
+	record.MeshName = sMeshName;
+	record.MorphName = sMorphName;
+	record.VertexCount = nVertexCount;
+	record.Indices = aIndices;
+	record.Deltas = aDeltas;
+	record.Scale = 1.0f;
+	m_aMorphs.append(record);
+}
+
+void DzBridgeMorphDeltaWriter::encodeMorph(MorphRecord& record, bool bQuantize, float fThreshold)
+{
+	int nNumDeltas = qMin(record.Indices.count(), record.Deltas.count() / 3);
+
+	// sort by vertex index, if the source was not already
+	QVector<int> order(nNumDeltas);
+	for (int i = 0; i < nNumDeltas; i++)
+		order[i] = i;
+	const QVector<qint32>& aSourceIndices = record.Indices;
+	if (!std::is_sorted(aSourceIndices.constBegin(), aSourceIndices.constBegin() + nNumDeltas))
+	{
+		std::sort(order.begin(), order.end(), [&aSourceIndices](int a, int b) { return aSourceIndices[a] < aSourceIndices[b]; });
+	}
+
+	// drop vertices that do not move and find the largest component for quantization
+	QVector<qint32> aIndices;
+	QVector<float> aDeltas;
+	aIndices.reserve(nNumDeltas);
+	aDeltas.reserve(nNumDeltas * 3);
+	float fMaxComponent = 0.0f;
+	foreach(int i, order)
+	{
+		float x = record.Deltas[i * 3 + 0];
+		float y = record.Deltas[i * 3 + 1];
+		float z = record.Deltas[i * 3 + 2];
+		if (fabs(x) < fThreshold && fabs(y) < fThreshold && fabs(z) < fThreshold)
+			continue;
+		if (aIndices.count() > 0 && aIndices.last() == record.Indices[i])
+			continue;
+		aIndices.append(record.Indices[i]);
+		aDeltas.append(x);
+		aDeltas.append(y);
+		aDeltas.append(z);
+		fMaxComponent = qMax(fMaxComponent, (float) qMax(fabs(x), qMax(fabs(y), fabs(z))));
+	}
+	record.Indices = aIndices;
+	record.Deltas = aDeltas;
+
+	record.Scale = 1.0f;
+	record.QuantizedDeltas.clear();
+	if (bQuantize)
+	{
+		record.Scale = (fMaxComponent > 0.0f) ? fMaxComponent / 32767.0f : 1.0f;
+		record.QuantizedDeltas.resize(aDeltas.count());
+		for (int i = 0; i < aDeltas.count(); i++)
+		{
+			float fValue = aDeltas[i] / record.Scale;
+			record.QuantizedDeltas[i] = (qint16) qBound(-32767.0f, (float) floor(fValue + 0.5f), 32767.0f);
+		}
+	}
+}
+
+bool DzBridgeMorphDeltaWriter::write(const QString& sFilename)
+{
+	// each morph is independent, so filtering and quantizing can run on all cores
+	bool bQuantize = m_bQuantize;
+	float fThreshold = m_fThreshold;
+	QtConcurrent::blockingMap(m_aMorphs, [bQuantize, fThreshold](MorphRecord& record) { encodeMorph(record, bQuantize, fThreshold); });
+
+	QFile file(sFilename);
+	if (file.open(QIODevice::WriteOnly) == false)
+		return false;
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+	stream.writeRawData("DZMD", 4);
+	stream << (quint32) 1;
+	stream << (quint32) (m_bQuantize ? 1 : 0);
+	stream << (quint32) m_aMorphs.count();
+
+	foreach(const MorphRecord& record, m_aMorphs)
+	{
+		QByteArray utf8 = record.MeshName.toUtf8();
+		stream << (quint32) utf8.size();
+		stream.writeRawData(utf8.constData(), utf8.size());
+		utf8 = record.MorphName.toUtf8();
+		stream << (quint32) utf8.size();
+		stream.writeRawData(utf8.constData(), utf8.size());
+
+		stream << (quint32) record.VertexCount;
+		stream << (quint32) record.Indices.count();
+		stream << record.Scale;
+		foreach(qint32 nIndex, record.Indices) stream << nIndex;
+		if (m_bQuantize)
+		{
+			foreach(qint16 nValue, record.QuantizedDeltas) stream << nValue;
+		}
+		else
+		{
+			foreach(float fValue, record.Deltas) stream << fValue;
+		}
+	}
+
+	bool bResult = (stream.status() == QDataStream::Ok);
+	file.close();
+
+	return bResult;
+}
@@ -0,0 +1,228 @@
+#include "dzproperty.h"
+#include "dzcontroller.h"
+#include "dzerclink.h"
+#include "dzbone.h"
+#include "dzmorph.h"
+#include "dzfloatproperty.h"
+
+#include <algorithm>
+
+#include "DzBridgeMorphLinkGraph.h"
+#include "DzBridgeMorphSelectionDialog.h"
+
+using namespace DzBridgeNameSpace;
+
+void DzBridgeMorphLinkGraph::clear()
+{
+	m_aEdges.clear();
+	m_mControllerToEdge.clear();
+	m_mControllerEdges.clear();
+	m_mSlaveEdges.clear();
+	m_aVisited.clear();
+}
+
+QString DzBridgeMorphLinkGraph::getPropertyName(DzProperty* pProperty)
+{
+	// edges without a resolved controller are expected here, so only non-null properties go to the shared helper
+	if (pProperty == nullptr)
+		return "";
+	return DzBridgeMorphSelectionDialog::getMorphPropertyName(pProperty);
+}
+
+QString DzBridgeMorphLinkGraph::getBoneName(DzProperty* pProperty)
+{
+	if (pProperty == nullptr)
+		return "None";
+	auto owner = pProperty->getOwner();
+	if (owner && owner->inherits("DzBone"))
+	{
+		return owner->getName();
+	}
+	return "None";
+}
+
+int DzBridgeMorphLinkGraph::findOrAddEdge(DzController* pController, DzProperty* pControllerProperty)
+{
+	QHash<DzController*, int>::const_iterator existing = m_mControllerToEdge.constFind(pController);
+	if (existing != m_mControllerToEdge.constEnd())
+		return existing.value();
+
+	MorphLinkEdge edge;
+	edge.Controller = pController;
+	edge.SlaveProperty = pController->getOwner();
+	edge.ERCLink = qobject_cast<DzERCLink*>(pController);
+	if (edge.ERCLink)
+	{
+		edge.ControllerProperty = edge.ERCLink->getProperty();
+		edge.Type = edge.ERCLink->getType();
+		edge.Scalar = edge.ERCLink->getScalar();
+		edge.Addend = edge.ERCLink->getAddend();
+		if (edge.Type == 6)
+		{
+			edge.KeyInterpolation = edge.ERCLink->getKeyInterpolation();
+			int nNumKeys = edge.ERCLink->getNumKeyValues();
+			edge.Keys.reserve(nNumKeys);
+			edge.KeyValues.reserve(nNumKeys);
+			for (int nKeyIndex = 0; nKeyIndex < nNumKeys; nKeyIndex++)
+			{
+				edge.Keys.append(edge.ERCLink->getKey(nKeyIndex));
+				edge.KeyValues.append(edge.ERCLink->getKeyValue(nKeyIndex));
+			}
+		}
+	}
+	else
+	{
+		edge.ControllerProperty = pControllerProperty;
+	}
+	edge.ControllerBone = getBoneName(edge.ControllerProperty);
+	edge.ControllerName = getPropertyName(edge.ControllerProperty);
+	edge.SlaveBone = getBoneName(edge.SlaveProperty);
+	edge.SlaveName = getPropertyName(edge.SlaveProperty);
+
+	int nIndex = m_aEdges.count();
+	m_aEdges.append(edge);
+	m_mControllerToEdge.insert(pController, nIndex);
+	return nIndex;
+}
+
+void DzBridgeMorphLinkGraph::addProperty(DzProperty* pProperty)
+{
+	if (pProperty == nullptr || m_aVisited.contains(pProperty))
+		return;
+	m_aVisited.insert(pProperty);
+
+	QVector<int>& aControllerEdges = m_mControllerEdges[pProperty];
+	for (auto iterator = pProperty->controllerListIterator(); iterator.hasNext(); )
+	{
+		DzController* pController = iterator.next();
+		// without an ERC link the driving property is unknown from this side
+		if (qobject_cast<DzERCLink*>(pController) == nullptr)
+			continue;
+		aControllerEdges.append(findOrAddEdge(pController, nullptr));
+	}
+
+	QVector<int>& aSlaveEdges = m_mSlaveEdges[pProperty];
+	for (auto iterator = pProperty->slaveControllerListIterator(); iterator.hasNext(); )
+	{
+		DzController* pController = iterator.next();
+		if (pController == nullptr || pController->getOwner() == nullptr)
+			continue;
+		aSlaveEdges.append(findOrAddEdge(pController, pProperty));
+	}
+}
+
+void DzBridgeMorphLinkGraph::addProperties(const QList<DzProperty*>& aProperties)
+{
+	foreach(DzProperty* pProperty, aProperties)
+	{
+		addProperty(pProperty);
+	}
+}
+
+QVector<int> DzBridgeMorphLinkGraph::getControllerEdges(DzProperty* pProperty)
+{
+	if (pProperty == nullptr)
+		return QVector<int>();
+	addProperty(pProperty);
+	return m_mControllerEdges.value(pProperty);
+}
+
+QVector<int> DzBridgeMorphLinkGraph::getSlaveEdges(DzProperty* pProperty)
+{
+	if (pProperty == nullptr)
+		return QVector<int>();
+	addProperty(pProperty);
+	return m_mSlaveEdges.value(pProperty);
+}
+
+bool DzBridgeMorphLinkGraph::getKeyCurveRange(DzProperty* pControllerProperty, const QVector<double>& aKeys, double& fMin, double& fMax)
+{
+	DzFloatProperty* pFloatProperty = qobject_cast<DzFloatProperty*>(pControllerProperty);
+	if (pFloatProperty && pFloatProperty->isClamped() && pFloatProperty->getMax() > pFloatProperty->getMin())
+	{
+		fMin = pFloatProperty->getMin();
+		fMax = pFloatProperty->getMax();
+		return true;
+	}
+	if (aKeys.isEmpty())
+		return false;
+
+	// unclamped controller: the curve is flat outside the keys, so the keyed range loses nothing
+	fMin = *std::min_element(aKeys.constBegin(), aKeys.constEnd());
+	fMax = *std::max_element(aKeys.constBegin(), aKeys.constEnd());
+	return fMax > fMin;
+}
+
+bool DzBridgeMorphLinkGraph::sampleKeyCurve(const QVector<double>& aKeys, const QVector<double>& aKeyValues, int nKeyInterpolation,
+	double fMin, double fMax, int nSize, QVector<float>& aTable)
+{
+	aTable.clear();
+	int nNumKeys = qMin(aKeys.count(), aKeyValues.count());
+	if (nNumKeys == 0 || nSize < 2)
+		return false;
+
+	// keys are normally stored in order, but the ERC link does not require it
+	QVector<QPair<double, double>> aSortedKeys(nNumKeys);
+	for (int i = 0; i < nNumKeys; i++)
+	{
+		aSortedKeys[i] = qMakePair(aKeys[i], aKeyValues[i]);
+	}
+	std::stable_sort(aSortedKeys.begin(), aSortedKeys.end(),
+		[](const QPair<double, double>& a, const QPair<double, double>& b) { return a.first < b.first; });
+
+	// Catmull-Rom tangents for non-uniform key spacing, one-sided at the end keys
+	QVector<double> aTangents(nNumKeys, 0.0);
+	if (nKeyInterpolation != 0 && nNumKeys > 1)
+	{
+		for (int i = 0; i < nNumKeys; i++)
+		{
+			int nPrev = qMax(i - 1, 0);
+			int nNext = qMin(i + 1, nNumKeys - 1);
+			double fSpan = aSortedKeys[nNext].first - aSortedKeys[nPrev].first;
+			if (fSpan > 0.0)
+				aTangents[i] = (aSortedKeys[nNext].second - aSortedKeys[nPrev].second) / fSpan;
+		}
+	}
+
+	aTable.resize(nSize);
+	double fStep = (fMax - fMin) / (nSize - 1);
+	int nSegment = 0;
+	for (int nSample = 0; nSample < nSize; nSample++)
+	{
+		double fInput = (nSample == nSize - 1) ? fMax : fMin + nSample * fStep;
+		double fValue;
+		if (fInput <= aSortedKeys[0].first)
+		{
+			fValue = aSortedKeys[0].second;
+		}
+		else if (fInput >= aSortedKeys[nNumKeys - 1].first)
+		{
+			fValue = aSortedKeys[nNumKeys - 1].second;
+		}
+		else
+		{
+			// inputs increase, so the segment search continues from the previous sample
+			while (aSortedKeys[nSegment + 1].first < fInput)
+				nSegment++;
+			double x0 = aSortedKeys[nSegment].first;
+			double x1 = aSortedKeys[nSegment + 1].first;
+			double y0 = aSortedKeys[nSegment].second;
+			double y1 = aSortedKeys[nSegment + 1].second;
+			double h = x1 - x0;
+			double t = (h > 0.0) ? (fInput - x0) / h : 1.0;
+			if (nKeyInterpolation == 0)
+			{
+				fValue = y0 + (y1 - y0) * t;
+			}
+			else
+			{
+				double t2 = t * t;
+				double t3 = t2 * t;
+				fValue = (2 * t3 - 3 * t2 + 1) * y0 + (t3 - 2 * t2 + t) * h * aTangents[nSegment]
+					+ (-2 * t3 + 3 * t2) * y1 + (t3 - t2) * h * aTangents[nSegment + 1];
+			}
+		}
+		aTable[nSample] = (float) fValue;
+	}
+	return true;
+}
@@ -0,0 +1,182 @@
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qdatastream.h>
+
+#include "DzBridgeMorphPresetIndex.h"
+
+using namespace DzBridgeNameSpace;
+
+void DzBridgeMorphPresetIndex::setFolder(const QString& sFolder)
+{
+	if (m_sFolder == sFolder)
+		return;
+	m_sFolder = sFolder;
+	clear();
+}
+
+void DzBridgeMorphPresetIndex::clear()
+{
+	m_aPresetNames.clear();
+	m_mPresets.clear();
+}
+
+void DzBridgeMorphPresetIndex::refresh()
+{
+	QHash<QString, PresetEntry> mOldPresets = m_mPresets;
+	m_aPresetNames.clear();
+	m_mPresets.clear();
+
+	QDirIterator it(m_sFolder, QStringList() << "*.csv" << "*.morphpreset", QDir::Files, QDirIterator::NoIteratorFlags);
+	while (it.hasNext())
+	{
+		QString sPath = it.next();
+		QFileInfo fileInfo = it.fileInfo();
+		QString sName = sPath.right(sPath.length() - m_sFolder.length() - 1);
+
+		PresetEntry entry = mOldPresets.value(sName);
+		if (!mOldPresets.contains(sName) || entry.Modified != fileInfo.lastModified() || entry.Size != fileInfo.size())
+		{
+			entry.Modified = fileInfo.lastModified();
+			entry.Size = fileInfo.size();
+			entry.Parsed = false;
+			entry.MorphNames.clear();
+		}
+		m_aPresetNames.append(sName);
+		m_mPresets.insert(sName, entry);
+	}
+}
+
+bool DzBridgeMorphPresetIndex::getMorphNames(const QString& sPresetName, QStringList& aMorphNames)
+{
+	aMorphNames.clear();
+	QString sFilePath = m_sFolder + QDir::separator() + sPresetName;
+	QFileInfo fileInfo(sFilePath);
+	if (!fileInfo.isFile())
+		return false;
+
+	QHash<QString, PresetEntry>::iterator entryIter = m_mPresets.find(sPresetName);
+	if (entryIter == m_mPresets.end())
+	{
+		// written since the last refresh(), e.g. LastUsed.csv on first export
+		PresetEntry entry;
+		entry.Size = -1;
+		entry.Parsed = false;
+		entryIter = m_mPresets.insert(sPresetName, entry);
+	}
+
+	PresetEntry& entry = entryIter.value();
+	if (!entry.Parsed || entry.Modified != fileInfo.lastModified() || entry.Size != fileInfo.size())
+	{
+		entry.Modified = fileInfo.lastModified();
+		entry.Size = fileInfo.size();
+		entry.MorphNames.clear();
+		bool bResult = isBinaryPreset(sFilePath) ? readBinaryPreset(sFilePath, entry.MorphNames) : readCsvPreset(sFilePath, entry.MorphNames);
+		if (!bResult)
+		{
+			m_mPresets.erase(entryIter);
+			return false;
+		}
+		entry.Parsed = true;
+	}
+
+	aMorphNames = entry.MorphNames;
+	return true;
+}
+
+bool DzBridgeMorphPresetIndex::readCsvPreset(const QString& sFilePath, QStringList& aMorphNames)
+{
+	QFile file(sFilePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	// only the first field of "Export" lines is needed, so lines are scanned in place instead of split
+	QByteArray data = file.readAll();
+	file.close();
+	static const QByteArray sExportTag("\"Export\"");
+	int nLineStart = 0;
+	while (nLineStart < data.size())
+	{
+		int nLineEnd = data.indexOf('\n', nLineStart);
+		if (nLineEnd < 0)
+			nLineEnd = data.size();
+		int nContentEnd = nLineEnd;
+		while (nContentEnd > nLineStart && data[nContentEnd - 1] == '\r')
+			nContentEnd--;
+
+		if (nContentEnd - nLineStart >= sExportTag.size() &&
+			qstrncmp(data.constData() + nContentEnd - sExportTag.size(), sExportTag.constData(), sExportTag.size()) == 0)
+		{
+			int nComma = data.indexOf(',', nLineStart);
+			if (nComma < 0 || nComma > nContentEnd)
+				nComma = nContentEnd;
+			QByteArray name = data.mid(nLineStart, nComma - nLineStart);
+			name.replace("\"", "");
+			aMorphNames.append(QString::fromUtf8(name.constData(), name.size()));
+		}
+		nLineStart = nLineEnd + 1;
+	}
+	return true;
+}
+
+bool DzBridgeMorphPresetIndex::readBinaryPreset(const QString& sFilePath, QStringList& aMorphNames)
+{
+	QFile file(sFilePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+
+	char magic[4];
+	quint32 nVersion = 0;
+	quint32 nCount = 0;
+	if (stream.readRawData(magic, 4) != 4 || qstrncmp(magic, "DZMP", 4) != 0)
+		return false;
+	stream >> nVersion >> nCount;
+	if (nVersion != 1 || stream.status() != QDataStream::Ok)
+		return false;
+	// every name takes at least its 4 byte length after the 12 byte header, so larger counts are corrupt
+	if (file.size() < 12 || nCount > (quint64) (file.size() - 12) / 4)
+		return false;
+
+	aMorphNames.reserve(nCount);
+	QByteArray utf8;
+	for (quint32 i = 0; i < nCount && stream.status() == QDataStream::Ok; i++)
+	{
+		quint32 nLength = 0;
+		stream >> nLength;
+		if (nLength > (quint32) file.size())
+			return false;
+		utf8.resize(nLength);
+		if (stream.readRawData(utf8.data(), nLength) != (int) nLength)
+			return false;
+		aMorphNames.append(QString::fromUtf8(utf8.constData(), utf8.size()));
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
+
+bool DzBridgeMorphPresetIndex::writeBinaryPreset(const QString& sFilePath, const QStringList& aMorphNames)
+{
+	QFile file(sFilePath);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData("DZMP", 4);
+	stream << (quint32) 1;
+	stream << (quint32) aMorphNames.count();
+	foreach(const QString& sMorphName, aMorphNames)
+	{
+		QByteArray utf8 = sMorphName.toUtf8();
+		stream << (quint32) utf8.size();
+		stream.writeRawData(utf8.constData(), utf8.size());
+	}
+
+	bool bResult = (stream.status() == QDataStream::Ok);
+	file.close();
+	return bResult;
+}
@@ -0,0 +1,112 @@
+#include "DzBridgeMorphSelectionDialog.h"
+#include "DzBridgeMorphSearchIndex.h"
+
+using namespace DzBridgeNameSpace;
+
+void DzBridgeMorphSearchIndex::clear()
+{
+	m_aNames.clear();
+	m_aLabels.clear();
+	m_aLowerLabels.clear();
+	m_mNameToId.clear();
+	m_mTrigrams.clear();
+}
+
+quint64 DzBridgeMorphSearchIndex::trigramKey(const QChar* pChars)
+{
+	return (quint64(pChars[0].unicode()) << 32) | (quint64(pChars[1].unicode()) << 16) | quint64(pChars[2].unicode());
+}
+
+void DzBridgeMorphSearchIndex::build(const QMap<QString, MorphInfo>& morphs)
+{
+	clear();
+	m_aNames.reserve(morphs.count());
+	m_aLabels.reserve(morphs.count());
+	m_aLowerLabels.reserve(morphs.count());
+
+	for (QMap<QString, MorphInfo>::const_iterator morphIter = morphs.constBegin(); morphIter != morphs.constEnd(); ++morphIter)
+	{
+		int nId = m_aNames.count();
+		QString sLowerLabel = morphIter.value().Label.toLower();
+		m_aNames.append(morphIter.value().Name);
+		m_aLabels.append(morphIter.value().Label);
+		m_aLowerLabels.append(sLowerLabel);
+		m_mNameToId.insert(morphIter.value().Name, nId);
+
+		// ids are added in ascending order, so each posting list stays sorted
+		const QChar* pChars = sLowerLabel.constData();
+		for (int i = 0; i + 3 <= sLowerLabel.length(); i++)
+		{
+			QVector<int>& postings = m_mTrigrams[trigramKey(pChars + i)];
+			if (postings.isEmpty() || postings.last() != nId)
+				postings.append(nId);
+		}
+	}
+}
+
+QVector<int> DzBridgeMorphSearchIndex::intersect(const QVector<int>& a, const QVector<int>& b)
+{
+	QVector<int> result;
+	result.reserve(qMin(a.count(), b.count()));
+	int i = 0;
+	int j = 0;
+	while (i < a.count() && j < b.count())
+	{
+		if (a[i] < b[j])
+			i++;
+		else if (b[j] < a[i])
+			j++;
+		else
+		{
+			result.append(a[i]);
+			i++;
+			j++;
+		}
+	}
+	return result;
+}
+
+QVector<int> DzBridgeMorphSearchIndex::query(const QString& sFilter, const QVector<int>* pCandidates) const
+{
+	QString sLowerFilter = sFilter.toLower();
+
+	QVector<int> candidates;
+	if (sLowerFilter.length() >= 3)
+	{
+		// start from the smallest posting list of the filter's trigrams
+		const QVector<int>* pSmallest = nullptr;
+		const QChar* pChars = sLowerFilter.constData();
+		for (int i = 0; i + 3 <= sLowerFilter.length(); i++)
+		{
+			QHash<quint64, QVector<int>>::const_iterator postings = m_mTrigrams.constFind(trigramKey(pChars + i));
+			if (postings == m_mTrigrams.constEnd())
+				return QVector<int>();
+			if (pSmallest == nullptr || postings.value().count() < pSmallest->count())
+				pSmallest = &postings.value();
+		}
+		candidates = pCandidates ? intersect(*pSmallest, *pCandidates) : *pSmallest;
+	}
+	else if (pCandidates)
+	{
+		candidates = *pCandidates;
+	}
+	else
+	{
+		candidates.reserve(m_aLowerLabels.count());
+		for (int nId = 0; nId < m_aLowerLabels.count(); nId++)
+			candidates.append(nId);
+	}
+
+	if (sLowerFilter.isEmpty())
+		return candidates;
+
+	// verify, trigrams only narrow the candidates down
+	QVector<int> result;
+	result.reserve(candidates.count());
+	foreach(int nId, candidates)
+	{
+		if (m_aLowerLabels[nId].contains(sLowerFilter))
+			result.append(nId);
+	}
+	return result;
+}
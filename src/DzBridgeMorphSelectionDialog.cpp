@@ -12,10 +12,16 @@
 #include <QtGui/qcombobox.h>
 #include <QtGui/qdesktopservices.h>
 #include <QtGui/qlistwidget.h>
-#include <QtGui/qtreewidget.h>
+#include <QtGui/qtreeview.h>
 #include <QtGui/qcheckbox.h>
 #include <QtGui/qdesktopservices.h>
 #include <QtCore/qdiriterator.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qpair.h>
+#include <algorithm>
 
 #include "dzapp.h"
 #include "dzscene.h"
@@ -44,12 +50,16 @@
 #include <QtCore/QDebug.h>
 
 #include "DzBridgeMorphSelectionDialog.h"
+#include "DzBridgeMorphTreeModel.h"
+#include "DzBridgeMorphLinkGraph.h"
 #include "DzBridgeAction.h"
 
 /*****************************
 Local definitions
 *****************************/
 #define DAZ_BRIDGE_LIBRARY_NAME "Daz Bridge"
+// Maximum number of morphs listed in the center box, the filter narrows it down further
+#define DAZ_BRIDGE_MORPH_LIST_LIMIT 2000
 
 using namespace DzBridgeNameSpace;
 
@@ -76,24 +86,30 @@ DzBridgeMorphSelectionDialog::DzBridgeMorphSelectionDialog(QWidget *parent) :
 
 	 morphListWidget = NULL;
 	 morphExportListWidget = NULL;
-	 morphTreeWidget = NULL;
+	 morphTreeView = NULL;
+	 morphTreeModel = NULL;
 	 filterEdit = NULL;
 	 presetCombo = NULL;
-	 fullBodyMorphTreeItem = NULL;
-	 charactersTreeItem = NULL;
 
 	// Set the dialog title 
 	setWindowTitle(tr("Select Morphs"));
 
 	// Setup folder
 	presetsFolder = QDesktopServices::storageLocation(QDesktopServices::DocumentsLocation) + QDir::separator() + "DAZ 3D"+ QDir::separator() + "Bridges" + QDir::separator() + "Daz To Unreal" + QDir::separator() + "Presets";
+	morphCatalogFolder = QDesktopServices::storageLocation(QDesktopServices::DocumentsLocation) + QDir::separator() + "DAZ 3D"+ QDir::separator() + "Bridges" + QDir::separator() + "Daz To Unreal" + QDir::separator() + "MorphCatalog";
+	morphCatalogPending = false;
+	connectedMorphsDepthLimit = 0;
+	jointLinkCacheValid = false;
 
 
 	QVBoxLayout* mainLayout = new QVBoxLayout();
 
 	// Left tree with morph structure
-	morphTreeWidget = new QTreeWidget(this);
-	morphTreeWidget->setHeaderHidden(true);
+	morphTreeModel = new DzBridgeMorphTreeModel(this);
+	morphTreeView = new QTreeView(this);
+	morphTreeView->setHeaderHidden(true);
+	morphTreeView->setUniformRowHeights(true);
+	morphTreeView->setModel(morphTreeModel);
 
 	// Center list showing morhps for selected tree items
 	morphListWidget = new QListWidget(this);
@@ -127,7 +143,7 @@ DzBridgeMorphSelectionDialog::DzBridgeMorphSelectionDialog(QWidget *parent) :
 	QVBoxLayout* treeLayout = new QVBoxLayout();
 	treeLayout->addWidget(new QLabel("Morph Groups"));
 	treeLayout->addWidget(new QLabel("Select to see available morphs"));
-	treeLayout->addWidget(morphTreeWidget);
+	treeLayout->addWidget(morphTreeView);
 
 	// Buttons for quickly adding certain JCMs
 	QGroupBox* MorphGroupBox = new QGroupBox("Morph Utilities", this);
@@ -207,11 +223,12 @@ DzBridgeMorphSelectionDialog::DzBridgeMorphSelectionDialog(QWidget *parent) :
 	resize(QSize(800, 750));//.expandedTo(minimumSizeHint()));
 	setFixedWidth(width());
 	setFixedHeight(height());
-	RefreshPresetsCombo();
+	presetIndex.setFolder(presetsFolder);
+	RefreshPresetsCombo(true);
 
 //	connect(morphListWidget, SIGNAL(itemChanged(QListWidgetItem*)), this, SLOT(ItemChanged(QListWidgetItem*)));
 
-	connect(morphTreeWidget, SIGNAL(itemSelectionChanged()),
+	connect(morphTreeView->selectionModel(), SIGNAL(selectionChanged(const QItemSelection &, const QItemSelection &)),
 		this, SLOT(ItemSelectionChanged()));
 
 	PrepareDialog();
@@ -243,38 +260,348 @@ void DzBridgeMorphSelectionDialog::PrepareDialog()
 	}
 
 	morphs.clear();
-	morphList = GetAvailableMorphs(Selection);
-	for (int ChildIndex = 0; ChildIndex < Selection->getNumNodeChildren(); ChildIndex++)
+	morphLinkGraph.clear();
+	InvalidateJointControlledMorphs();
+
+	// Use the cached morph catalog for this figure if there is one, and verify it once the dialog is up.
+	// Properties are only resolved by the verification, see EnsureMorphCatalogVerified().
+	morphCatalogPending = false;
+	morphCatalogNode = Selection;
+	morphCatalogPath = GetMorphCatalogPath(Selection);
+	if (!morphCatalogPath.isEmpty() && LoadMorphCatalog(morphCatalogPath))
 	{
-		DzNode* ChildNode = Selection->getNodeChild(ChildIndex);
-		morphList.append(GetAvailableMorphs(ChildNode));
+		morphCatalogPending = true;
+		QTimer::singleShot(0, this, SLOT(VerifyMorphCatalog()));
+	}
+	else
+	{
+		ScanMorphs(Selection);
+		SaveMorphCatalog(morphCatalogPath, Selection);
 	}
 
 	//GetActiveJointControlledMorphs(Selection);
 
-	UpdateMorphsTree();
+	RefreshMorphViews();
+	RefreshPresetsCombo(true);
 	HandlePresetChanged("LastUsed.csv");
 }
 
-// When the filter text is changed, update the center list
-void DzBridgeMorphSelectionDialog::FilterChanged(const QString& filter)
+// Full scan of the figure and its children for morphs
+void DzBridgeMorphSelectionDialog::ScanMorphs(DzNode* Node)
 {
-	morphListWidget->clear();
-	QString newFilter = filter;
-	morphListWidget->clear();
-	foreach(MorphInfo morphInfo, selectedInTree)
+	morphs.clear();
+	morphCatalogLocations.clear();
+	morphList = GetAvailableMorphs(Node);
+	for (int ChildIndex = 0; ChildIndex < Node->getNumNodeChildren(); ChildIndex++)
+	{
+		DzNode* ChildNode = Node->getNodeChild(ChildIndex);
+		morphList.append(GetAvailableMorphs(ChildNode));
+	}
+}
+
+// Rebuild the search index and the left tree from morphs
+void DzBridgeMorphSelectionDialog::RefreshMorphViews()
+{
+	selectedInTree.clear();
+	lastFilter = QString();
+	lastFilterResult.clear();
+	morphSearchIndex.build(morphs);
+
+	UpdateMorphsTree();
+}
+
+// Figure and direct children, in the order used by the morph catalog
+static DzNodeList getMorphCatalogNodes(DzNode* Node)
+{
+	DzNodeList nodeList;
+	nodeList.append(Node);
+	for (int ChildIndex = 0; ChildIndex < Node->getNumNodeChildren(); ChildIndex++)
+	{
+		nodeList.append(Node->getNodeChild(ChildIndex));
+	}
+	return nodeList;
+}
+
+// Cache file for the figure asset, empty if the figure has no asset id
+QString DzBridgeMorphSelectionDialog::GetMorphCatalogPath(DzNode* Node)
+{
+	if (Node == nullptr || Node->getAssetId().isEmpty())
+		return QString();
+
+	QString assetHash = QCryptographicHash::hash(Node->getAssetId().toUtf8(), QCryptographicHash::Md5).toHex();
+	return morphCatalogFolder + QDir::separator() + assetHash + ".morphcatalog";
+}
+
+// Hash of the node names, node property counts and morph modifier names of the figure and its children.
+// Installing or removing morphs changes the modifiers, so a matching fingerprint means the cached morphs still
+// resolve; their labels and paths are refreshed by ResolveMorphCatalog().
+QString DzBridgeMorphSelectionDialog::GetMorphCatalogFingerprint(DzNode* Node)
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	foreach(DzNode* catalogNode, getMorphCatalogNodes(Node))
 	{
-		if (newFilter == NULL || newFilter.isEmpty() || morphInfo.Label.contains(newFilter, Qt::CaseInsensitive))
+		hash.addData(QString("%1:%2").arg(catalogNode->getName()).arg(catalogNode->getNumProperties()).toUtf8());
+		DzObject* Object = catalogNode->getObject();
+		if (Object == nullptr)
+			continue;
+		hash.addData(QString(":%1").arg(Object->getNumModifiers()).toUtf8());
+		for (int index = 0; index < Object->getNumModifiers(); index++)
 		{
-			SortingListItem* item = new SortingListItem();// modLabel, morphListWidget);
-			item->setText(morphInfo.Label);
-			item->setData(Qt::UserRole, morphInfo.Name);
+			hash.addData(Object->getModifier(index)->getName().toUtf8());
+			hash.addData("\n", 1);
+		}
+	}
+	return hash.result().toHex();
+}
+
+bool DzBridgeMorphSelectionDialog::LoadMorphCatalog(QString filePath)
+{
+	morphCatalogLocations.clear();
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_4_8);
+	quint32 magic = 0;
+	quint32 version = 0;
+	stream >> magic >> version;
+	if (magic != 0x445A4D43 || version != 1) // "DZMC"
+		return false;
+
+	quint32 numMorphs = 0;
+	stream >> morphCatalogFingerprint >> numMorphs;
+	for (quint32 i = 0; i < numMorphs && stream.status() == QDataStream::Ok; i++)
+	{
+		MorphInfo morphInfo;
+		MorphCatalogLocation location;
+		stream >> morphInfo.Name >> morphInfo.Label >> morphInfo.Type >> morphInfo.Path;
+		stream >> location.NodeIndex >> location.ModifierIndex >> location.PropertyIndex;
+		morphs.insert(morphInfo.Name, morphInfo);
+		morphCatalogLocations.insert(morphInfo.Name, location);
+	}
+	if (stream.status() != QDataStream::Ok)
+	{
+		morphs.clear();
+		morphCatalogLocations.clear();
+		return false;
+	}
+	return true;
+}
+
+void DzBridgeMorphSelectionDialog::SaveMorphCatalog(QString filePath, DzNode* Node)
+{
+	if (filePath.isEmpty())
+		return;
+
+	// locate each morph property by node, modifier and property index so the catalog can be resolved without a scan
+	DzNodeList nodeList = getMorphCatalogNodes(Node);
+	QHash<DzProperty*, MorphCatalogLocation> propertyLocations;
+	for (int nodeIndex = 0; nodeIndex < nodeList.count(); nodeIndex++)
+	{
+		DzNode* catalogNode = nodeList[nodeIndex];
+		MorphCatalogLocation location;
+		location.NodeIndex = nodeIndex;
+		location.ModifierIndex = -1;
+		for (int index = 0; index < catalogNode->getNumProperties(); index++)
+		{
+			location.PropertyIndex = index;
+			propertyLocations.insert(catalogNode->getProperty(index), location);
+		}
+		DzObject* Object = catalogNode->getObject();
+		if (Object == nullptr)
+			continue;
+		for (int index = 0; index < Object->getNumModifiers(); index++)
+		{
+			DzModifier* modifier = Object->getModifier(index);
+			if (qobject_cast<DzMorph*>(modifier) == nullptr)
+				continue;
+			location.ModifierIndex = index;
+			for (int propindex = 0; propindex < modifier->getNumProperties(); propindex++)
+			{
+				location.PropertyIndex = propindex;
+				propertyLocations.insert(modifier->getProperty(propindex), location);
+			}
+		}
+	}
+
+	QDir dir;
+	dir.mkpath(morphCatalogFolder);
+	QFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		dzApp->log("DazBridge: WARNING: unable to write morph catalog: " + filePath);
+		return;
+	}
+
+	morphCatalogFingerprint = GetMorphCatalogFingerprint(Node);
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_4_8);
+	stream << quint32(0x445A4D43) << quint32(1); // "DZMC", version 1
+	stream << morphCatalogFingerprint << quint32(morphs.count());
+	morphCatalogLocations.clear();
+	foreach(MorphInfo morphInfo, morphs)
+	{
+		MorphCatalogLocation location = propertyLocations.value(morphInfo.Property);
+		stream << morphInfo.Name << morphInfo.Label << morphInfo.Type << morphInfo.Path;
+		stream << location.NodeIndex << location.ModifierIndex << location.PropertyIndex;
+		morphCatalogLocations.insert(morphInfo.Name, location);
+	}
+	file.close();
+}
+
+// Resolve Property and Node of the cached morphs.  Returns false if any of them no longer matches.
+// Label and Path are taken from the scene again, since the catalog is shared by all instances of the asset
+// and the fingerprint does not cover node or property labels; bLabelsChanged is set if any of them differ.
+bool DzBridgeMorphSelectionDialog::ResolveMorphCatalog(DzNode* Node, bool& bLabelsChanged)
+{
+	bLabelsChanged = false;
+	DzNodeList nodeList = getMorphCatalogNodes(Node);
+	for (QMap<QString, MorphInfo>::iterator morphIter = morphs.begin(); morphIter != morphs.end(); ++morphIter)
+	{
+		MorphInfo& morphInfo = morphIter.value();
+		MorphCatalogLocation location = morphCatalogLocations.value(morphInfo.Name);
+		if (location.NodeIndex < 0 || location.NodeIndex >= nodeList.count())
+			return false;
+		DzNode* catalogNode = nodeList[location.NodeIndex];
+
+		DzProperty* property = nullptr;
+		if (location.ModifierIndex == -1)
+		{
+			if (location.PropertyIndex >= 0 && location.PropertyIndex < catalogNode->getNumProperties())
+				property = catalogNode->getProperty(location.PropertyIndex);
+			if (property == nullptr || property->getName() != morphInfo.Name)
+				return false;
+		}
+		else
+		{
+			DzObject* Object = catalogNode->getObject();
+			if (Object == nullptr || location.ModifierIndex >= Object->getNumModifiers())
+				return false;
+			DzModifier* modifier = Object->getModifier(location.ModifierIndex);
+			if (modifier->getName() != morphInfo.Name || location.PropertyIndex < 0 || location.PropertyIndex >= modifier->getNumProperties())
+				return false;
+			property = modifier->getProperty(location.PropertyIndex);
+		}
+		// same as GetAvailableMorphs()
+		QString propLabel = property->getLabel();
+		QString propPath = catalogNode->getLabel() + "/" + property->getPath();
+		if (morphInfo.Label != propLabel || morphInfo.Path != propPath)
+		{
+			morphInfo.Label = propLabel;
+			morphInfo.Path = propPath;
+			bLabelsChanged = true;
+		}
+		morphInfo.Property = property;
+		morphInfo.Node = catalogNode;
+	}
+	return true;
+}
+
+// Deferred check of a catalog loaded by PrepareDialog, falls back to a full scan if the figure's morphs changed
+void DzBridgeMorphSelectionDialog::VerifyMorphCatalog()
+{
+	if (!morphCatalogPending)
+		return;
+	morphCatalogPending = false;
+	if (morphCatalogNode.isNull())
+		return;
+
+	bool bLabelsChanged = false;
+	if (GetMorphCatalogFingerprint(morphCatalogNode) == morphCatalogFingerprint && ResolveMorphCatalog(morphCatalogNode, bLabelsChanged))
+	{
+		if (bLabelsChanged)
+		{
+			// renamed figure or relabeled morphs: the views were built from the cached labels
+			SaveMorphCatalog(morphCatalogPath, morphCatalogNode);
+			RefreshMorphViews();
+			FilterChanged(filterEdit->text());
+		}
+		// export list entries were copied before the properties were resolved
+		MorphInfoRegistry previousExport = morphsToExport;
+		morphsToExport.clear();
+		foreach(MorphInfo exportMorph, previousExport)
+		{
+			morphsToExport.append(morphs.value(exportMorph.Name, exportMorph));
+		}
+		if (bLabelsChanged)
+			RefreshExportMorphList();
+		return;
+	}
+
+	dzApp->log("DazBridge: Morph catalog is out of date, rescanning morphs for: " + morphCatalogNode->getLabel());
+	QStringList exportMorphNames;
+	foreach(MorphInfo exportMorph, morphsToExport)
+	{
+		exportMorphNames.append(exportMorph.Name);
+	}
+	ScanMorphs(morphCatalogNode);
+	SaveMorphCatalog(morphCatalogPath, morphCatalogNode);
+	RefreshMorphViews();
+	FilterChanged(filterEdit->text());
 
-			morphListWidget->addItem(item);
+	morphsToExport.clear();
+	foreach(QString morphName, exportMorphNames)
+	{
+		if (morphs.contains(morphName))
+		{
+			morphsToExport.append(morphs[morphName]);
 		}
 	}
+	RefreshExportMorphList();
+}
+
+// Makes sure the morph catalog has been verified and all MorphInfo properties are resolved
+void DzBridgeMorphSelectionDialog::EnsureMorphCatalogVerified()
+{
+	if (morphCatalogPending)
+	{
+		VerifyMorphCatalog();
+	}
+}
+
+// When the filter text is changed, update the center list
+void DzBridgeMorphSelectionDialog::FilterChanged(const QString& filter)
+{
+	QString newFilter = filter.toLower();
 
-	morphListWidget->sortItems();
+	// a filter that contains the previous one can only narrow down the previous result
+	QVector<int> filterResult;
+	if (!lastFilter.isNull() && newFilter.contains(lastFilter))
+	{
+		filterResult = morphSearchIndex.query(newFilter, &lastFilterResult);
+	}
+	else
+	{
+		filterResult = morphSearchIndex.query(newFilter, &selectedInTree);
+	}
+	lastFilter = newFilter;
+	lastFilterResult = filterResult;
+
+	// same order as sortItems(), so only the first DAZ_BRIDGE_MORPH_LIST_LIMIT need to be created
+	std::sort(filterResult.begin(), filterResult.end(), [this](int a, int b)
+	{
+		return morphSearchIndex.getLabel(a) < morphSearchIndex.getLabel(b);
+	});
+	int numItems = qMin(filterResult.count(), DAZ_BRIDGE_MORPH_LIST_LIMIT);
+
+	morphListWidget->setUpdatesEnabled(false);
+	morphListWidget->clear();
+	for (int i = 0; i < numItems; i++)
+	{
+		SortingListItem* item = new SortingListItem();// modLabel, morphListWidget);
+		item->setText(morphSearchIndex.getLabel(filterResult[i]));
+		item->setData(Qt::UserRole, morphSearchIndex.getName(filterResult[i]));
+
+		morphListWidget->addItem(item);
+	}
+	if (filterResult.count() > numItems)
+	{
+		QListWidgetItem* item = new QListWidgetItem(QString("... %1 more morphs, refine the filter to see them").arg(filterResult.count() - numItems));
+		item->setFlags(Qt::NoItemFlags);
+		morphListWidget->addItem(item);
+	}
+	morphListWidget->setUpdatesEnabled(true);
 }
 
 // Build a list of availaboe morphs for the node
@@ -396,9 +723,13 @@ QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetActiveJointControlledMorph
 			}
 		}
 
+		if (jointLinkCacheValid && jointLinkCacheNode == Node)
+		{
+			return jointLinkCache;
+		}
+		InvalidateJointControlledMorphs();
 
 		DzObject* Object = Node->getObject();
-		DzShape* Shape = Object ? Object->getCurrentShape() : NULL;
 
 		for (int index = 0; index < Node->getNumProperties(); index++)
 		{
@@ -411,8 +742,6 @@ QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetActiveJointControlledMorph
 			for (int index = 0; index < Object->getNumModifiers(); index++)
 			{
 				DzModifier* modifier = Object->getModifier(index);
-				QString modName = modifier->getName();
-				QString modLabel = modifier->getLabel();
 				DzMorph* mod = qobject_cast<DzMorph*>(modifier);
 				if (mod)
 				{
@@ -427,32 +756,51 @@ QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetActiveJointControlledMorph
 			}
 		}
 
+		// the figure going away, a JCM's controllers changing, or a body morph being dialed all change the result
+		jointLinkCacheWatched.append(Node);
+		connect(Node, SIGNAL(destroyed()), this, SLOT(InvalidateJointControlledMorphs()), Qt::UniqueConnection);
+
+		jointLinkCacheNode = Node;
+		jointLinkCache = returnMorphs;
+		jointLinkCacheValid = true;
 	}
 
 	return returnMorphs;
 }
 
+void DzBridgeMorphSelectionDialog::InvalidateJointControlledMorphs()
+{
+	foreach(QPointer<QObject> watched, jointLinkCacheWatched)
+	{
+		if (watched)
+			disconnect(watched, 0, this, SLOT(InvalidateJointControlledMorphs()));
+	}
+	jointLinkCacheWatched.clear();
+	jointLinkCache.clear();
+	jointLinkCacheNode = nullptr;
+	jointLinkCacheValid = false;
+}
+
+// Returns the JCM info of property, if it is an active joint controlled corrective.
+// Changes to its controllers or to the body morph that enables it invalidate the cached result.
 QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetJointControlledMorphInfo(DzProperty* property)
 {
 	QList<JointLinkInfo> returnMorphs;
 
-	QString propName = property->getName();
-	QString propLabel = property->getLabel();
 	DzPresentation* presentation = property->getPresentation();
 	if (presentation && presentation->getType() == "Modifier/Corrective")
 	{
 		QString linkLabel;
-		QString linkDescription;
 		QString linkBone;
 		QString linkAxis;
-		QString linkBodyType;
-		double bodyStrength = 0.0f;
+		DzNumericProperty* bodyProperty = nullptr;
 		double currentBodyScalar = 0.0f;
 		double linkScalar = 0.0f;
 		bool isJCM = false;
-		QList<double> keys;
-		QList<double> keysValues;
-		QList<JointLinkKey> linkKeys;
+		int linkKeyInterpolation = 0;
+		double linkMinimum = 0.0;
+		double linkMaximum = 0.0;
+		QVector<JointLinkKey> linkKeys;
 
 		for (int ControllerIndex = 0; ControllerIndex < property->getNumControllers(); ControllerIndex++)
 		{
@@ -461,43 +809,50 @@ QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetJointControlledMorphInfo(D
 			DzERCLink* link = qobject_cast<DzERCLink*>(controller);
 			if (link)
 			{
-				double value = link->getScalar();
-				QString linkProperty = link->getProperty()->getName();
-				QString linkObject = link->getProperty()->getOwner()->getName();
-				double currentValue = link->getProperty()->getDoubleValue();
-
-				DzBone* bone = qobject_cast<DzBone*>(link->getProperty()->getOwner());
+				DzNumericProperty* linkProperty = link->getProperty();
+				DzBone* bone = qobject_cast<DzBone*>(linkProperty->getOwner());
 				if (bone)
 				{
-					linkLabel = propLabel;
-					linkDescription = controller->description();
-					linkBone = linkObject;
-					linkAxis = linkProperty;
-					linkScalar = value;
+					linkLabel = property->getLabel();
+					linkBone = bone->getName();
+					linkAxis = linkProperty->getName();
+					linkScalar = link->getScalar();
 					isJCM = true;
 
 					if (link->getType() == 6)
 					{
-						for (int keyIndex = 0; keyIndex < link->getNumKeyValues(); keyIndex++)
+						int numKeys = link->getNumKeyValues();
+						linkKeys.resize(numKeys);
+						QVector<double> keyAngles(numKeys);
+						for (int keyIndex = 0; keyIndex < numKeys; keyIndex++)
 						{
-							JointLinkKey newKey;
-							newKey.Angle = link->getKey(keyIndex);
-							newKey.Value = link->getKeyValue(keyIndex);
-							linkKeys.append(newKey);
-							keys.append(link->getKey(keyIndex));
-							keysValues.append(link->getKeyValue(keyIndex));
+							linkKeys[keyIndex].Angle = link->getKey(keyIndex);
+							linkKeys[keyIndex].Value = link->getKeyValue(keyIndex);
+							keyAngles[keyIndex] = linkKeys[keyIndex].Angle;
 						}
+						linkKeyInterpolation = link->getKeyInterpolation();
+						DzBridgeMorphLinkGraph::getKeyCurveRange(linkProperty, keyAngles, linkMinimum, linkMaximum);
 					}
 				}
 				else
 				{
-					linkBodyType = linkObject;
-					bodyStrength = value;
-					currentBodyScalar = currentValue;
+					bodyProperty = linkProperty;
+					currentBodyScalar = linkProperty->getDoubleValue();
 				}
 			}
 		}
 
+		if (isJCM)
+		{
+			jointLinkCacheWatched.append(property);
+			connect(property, SIGNAL(controllerListChanged()), this, SLOT(InvalidateJointControlledMorphs()), Qt::UniqueConnection);
+			if (bodyProperty)
+			{
+				jointLinkCacheWatched.append(bodyProperty);
+				connect(bodyProperty, SIGNAL(currentValueChanged()), this, SLOT(InvalidateJointControlledMorphs()), Qt::UniqueConnection);
+			}
+		}
+
 		if (isJCM && currentBodyScalar > 0.0f)
 		{
 			JointLinkInfo linkInfo;
@@ -506,24 +861,11 @@ QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetJointControlledMorphInfo(D
 			linkInfo.Morph = linkLabel;
 			linkInfo.Scalar = linkScalar;
 			linkInfo.Alpha = currentBodyScalar;
+			linkInfo.KeyInterpolation = linkKeyInterpolation;
+			linkInfo.Minimum = linkMinimum;
+			linkInfo.Maximum = linkMaximum;
 			linkInfo.Keys = linkKeys;
-			qDebug() << "Label " << linkLabel << " Description " << linkDescription << " Bone " << linkBone << " Axis " << linkAxis << " Alpha " << currentBodyScalar << " Scalar " << linkScalar;
-			if (!keys.isEmpty())
-			{
-				foreach(double key, keys)
-				{
-					qDebug() << key;
-				}
-
-				foreach(double key, keysValues)
-				{
-					qDebug() << key;
-				}
-
-			}
-
 			returnMorphs.append(linkInfo);
-
 		}
 	}
 	return returnMorphs;
@@ -532,63 +874,12 @@ QList<JointLinkInfo> DzBridgeMorphSelectionDialog::GetJointControlledMorphInfo(D
 // Build out the left tree
 void DzBridgeMorphSelectionDialog::UpdateMorphsTree()
 {
-	morphTreeWidget->clear();
-	morphsForNode.clear();
-	foreach(QString morph, morphs.keys())
-	{
-		QString path = morphs[morph].Path;
-		QTreeWidgetItem* parentItem = nullptr;
-		foreach(QString pathPart, path.split("/"))
-		{
-			if (pathPart == "") continue;
-			parentItem = FindTreeItem(parentItem, pathPart);
-
-			if (!morphsForNode.keys().contains(parentItem))
-			{
-				morphsForNode.insert(parentItem, QList<MorphInfo>());
-			}
-			morphsForNode[parentItem].append(morphs[morph]);
-		}
-	}
-}
-
-// This function could be better named.  It will find the node matching the property path
-// but it will also create the structure of that path in the tree as needed as it searches
-QTreeWidgetItem* DzBridgeMorphSelectionDialog::FindTreeItem(QTreeWidgetItem* parent, QString name)
-{
-	if (parent == nullptr)
-	{
-		for(int i = 0; i < morphTreeWidget->topLevelItemCount(); i++)
-		{
-			QTreeWidgetItem* item = morphTreeWidget->topLevelItem(i);
-			if (item->text(0) == name)
-			{
-				return item;
-			}
-		}
+	morphTreeModel->setMorphs(morphs);
 
-		QTreeWidgetItem* newItem = new QTreeWidgetItem(morphTreeWidget);
-		newItem->setText(0, name);
-		newItem->setExpanded(true);
-		morphTreeWidget->addTopLevelItem(newItem);
-		return newItem;
-	}
-	else
+	// only the top level nodes are expanded up front, deeper groups are fetched when the user expands them
+	for (int row = 0; row < morphTreeModel->rowCount(); row++)
 	{
-		for (int i = 0; i < parent->childCount(); i++)
-		{
-			QTreeWidgetItem* item = parent->child(i);
-			if (item->text(0) == name)
-			{
-				return item;
-			}
-		}
-
-		QTreeWidgetItem* newItem = new QTreeWidgetItem(parent);
-		newItem->setText(0, name);
-		newItem->setExpanded(true);
-		parent->addChild(newItem);
-		return newItem;
+		morphTreeView->expand(morphTreeModel->index(row, 0));
 	}
 }
 
@@ -596,21 +887,29 @@ QTreeWidgetItem* DzBridgeMorphSelectionDialog::FindTreeItem(QTreeWidgetItem* par
 void DzBridgeMorphSelectionDialog::ItemSelectionChanged()
 {
 	selectedInTree.clear();
-	foreach(QTreeWidgetItem* selectedItem, morphTreeWidget->selectedItems())
+	foreach(QModelIndex selectedIndex, morphTreeView->selectionModel()->selectedIndexes())
 	{
-		SelectMorphsInNode(selectedItem);
+		SelectMorphsInNode(selectedIndex);
 	}
+	std::sort(selectedInTree.begin(), selectedInTree.end());
+	selectedInTree.erase(std::unique(selectedInTree.begin(), selectedInTree.end()), selectedInTree.end());
+
+	// the candidates changed, start the next filter from scratch
+	lastFilter = QString();
+	lastFilterResult.clear();
 
 	FilterChanged(filterEdit->text());
 }
 
 // Updates the list of selected morphs in the Left Tree
 // including any children
-void DzBridgeMorphSelectionDialog::SelectMorphsInNode(QTreeWidgetItem* item)
+void DzBridgeMorphSelectionDialog::SelectMorphsInNode(const QModelIndex& index)
 {
-	if (morphsForNode.keys().contains(item))
+	foreach(MorphInfo morphInfo, morphTreeModel->getMorphsForIndex(index))
 	{
-		selectedInTree.append(morphsForNode[item]);
+		int morphId = morphSearchIndex.findId(morphInfo.Name);
+		if (morphId != -1)
+			selectedInTree.append(morphId);
 	}
 }
 
@@ -620,7 +919,7 @@ void DzBridgeMorphSelectionDialog::HandleAddMorphsButton()
 	foreach(QListWidgetItem* selectedItem, morphListWidget->selectedItems())
 	{
 		QString morphName = selectedItem->data(Qt::UserRole).toString();
-		if (morphs.contains(morphName) && !morphsToExport.contains(morphs[morphName]))
+		if (morphs.contains(morphName))
 		{
 			morphsToExport.append(morphs[morphName]);
 		}
@@ -635,10 +934,7 @@ void DzBridgeMorphSelectionDialog::HandleRemoveMorphsButton()
 	foreach(QListWidgetItem* selectedItem, morphExportListWidget->selectedItems())
 	{
 		QString morphName = selectedItem->data(Qt::UserRole).toString();
-		if (morphs.keys().contains(morphName))
-		{
-			morphsToExport.removeAll(morphs[morphName]);
-		}
+		morphsToExport.remove(morphName);
 	}
 	RefreshExportMorphList();
 	RefreshPresetsCombo();
@@ -647,7 +943,7 @@ void DzBridgeMorphSelectionDialog::HandleRemoveMorphsButton()
 // Brings up a dialgo for choosing a preset name
 void DzBridgeMorphSelectionDialog::HandleSavePreset()
 {
-	QString filters("CSV Files (*.csv)");
+	QString filters("CSV Files (*.csv);;Binary Preset Files (*.morphpreset)");
 	QString defaultFilter("CSV Files (*.csv)");
 	QDir dir;
 	dir.mkpath(presetsFolder);
@@ -673,6 +969,18 @@ void DzBridgeMorphSelectionDialog::SavePresetFile(QString filePath)
 		filePath = presetsFolder + QDir::separator() + "LastUsed.csv";
 	}
 
+	if (DzBridgeMorphPresetIndex::isBinaryPreset(filePath))
+	{
+		QStringList morphNames;
+		foreach(MorphInfo exportMorph, morphsToExport)
+		{
+			morphNames.append(exportMorph.Name);
+		}
+		DzBridgeMorphPresetIndex::writeBinaryPreset(filePath, morphNames);
+		RefreshPresetsCombo(true);
+		return;
+	}
+
 	QFile file(filePath);
 	file.open(QIODevice::WriteOnly | QIODevice::Text);
 	QTextStream out(&file);
@@ -680,7 +988,7 @@ void DzBridgeMorphSelectionDialog::SavePresetFile(QString filePath)
 
 	// optional, as QFile destructor will already do it:
 	file.close();
-	RefreshPresetsCombo();
+	RefreshPresetsCombo(true);
 
 }
 
@@ -730,7 +1038,7 @@ void DzBridgeMorphSelectionDialog::HandleArmJCMMorphsButton()
 	// Add the list for export
 	foreach(QString MorphName, MorphsToAdd)
 	{
-		if (morphs.contains(MorphName) && !morphsToExport.contains(morphs[MorphName]))
+		if (morphs.contains(MorphName))
 		{
 			morphsToExport.append(morphs[MorphName]);
 		}
@@ -768,7 +1076,7 @@ void DzBridgeMorphSelectionDialog::HandleLegJCMMorphsButton()
 	// Add the list for export
 	foreach(QString MorphName, MorphsToAdd)
 	{
-		if (morphs.contains(MorphName) && !morphsToExport.contains(morphs[MorphName]))
+		if (morphs.contains(MorphName))
 		{
 			morphsToExport.append(morphs[MorphName]);
 		}
@@ -805,7 +1113,7 @@ void DzBridgeMorphSelectionDialog::HandleTorsoJCMMorphsButton()
 	// Add the list for export
 	foreach(QString MorphName, MorphsToAdd)
 	{
-		if (morphs.contains(MorphName) && !morphsToExport.contains(morphs[MorphName]))
+		if (morphs.contains(MorphName))
 		{
 			morphsToExport.append(morphs[MorphName]);
 		}
@@ -878,7 +1186,7 @@ void DzBridgeMorphSelectionDialog::HandleARKitGenesis81MorphsButton()
 	// Add the list for export
 	foreach(QString MorphName, MorphsToAdd)
 	{
-		if (morphs.contains(MorphName) && !morphsToExport.contains(morphs[MorphName]))
+		if (morphs.contains(MorphName))
 		{
 			morphsToExport.append(morphs[MorphName]);
 		}
@@ -902,7 +1210,7 @@ void DzBridgeMorphSelectionDialog::HandleFaceFXGenesis8Button()
 	// Add the list for export
 	foreach(QString MorphName, MorphsToAdd)
 	{
-		if (morphs.contains(MorphName) && !morphsToExport.contains(morphs[MorphName]))
+		if (morphs.contains(MorphName))
 		{
 			morphsToExport.append(morphs[MorphName]);
 		}
@@ -931,20 +1239,18 @@ void DzBridgeMorphSelectionDialog::RefreshExportMorphList()
 }
 
 // Refresh the list of preset csvs from the files in the folder
-void DzBridgeMorphSelectionDialog::RefreshPresetsCombo()
+void DzBridgeMorphSelectionDialog::RefreshPresetsCombo(bool bRescan)
 {
 	disconnect(presetCombo, SIGNAL(currentIndexChanged(const QString &)), this, SLOT(HandlePresetChanged(const QString &)));
 
-	presetCombo->clear();
-	presetCombo->addItem("None");
-
-	QDirIterator it(presetsFolder, QStringList() << "*.csv", QDir::NoFilter, QDirIterator::NoIteratorFlags);
-	while (it.hasNext()) 
+	if (bRescan)
 	{
-		QString Path = it.next();
-		QString NewPath = Path.right(Path.length() - presetsFolder.length() - 1);
-		presetCombo->addItem(NewPath);
+		presetIndex.refresh();
 	}
+
+	presetCombo->clear();
+	presetCombo->addItem("None");
+	presetCombo->addItems(presetIndex.getPresetNames());
 	connect(presetCombo, SIGNAL(currentIndexChanged(const QString &)), this, SLOT(HandlePresetChanged(const QString &)));
 }
 
@@ -952,33 +1258,25 @@ void DzBridgeMorphSelectionDialog::RefreshPresetsCombo()
 void DzBridgeMorphSelectionDialog::HandlePresetChanged(const QString& presetName)
 {
 	morphsToExport.clear();
-	QString PresetFilePath = presetsFolder + QDir::separator() + presetName;
 
-	QFile file(PresetFilePath);
-	if (!file.open(QIODevice::ReadOnly)) {
+	// the preset's morph names are parsed once and kept by presetIndex, until the file changes
+	QStringList presetMorphNames;
+	if (!presetIndex.getMorphNames(presetName, presetMorphNames)) {
 		// TODO: should be an error dialog
 		return;
 	}
 
-	// load the selected csv from disk into the export list on the right
-	QTextStream InStream(&file);
-
-	while (!InStream.atEnd()) {
-		QString MorphLine = InStream.readLine();
-		if (MorphLine.endsWith("\"Export\""))
+	foreach(const QString& MorphName, presetMorphNames)
+	{
+		QMap<QString, MorphInfo>::const_iterator morphIter = morphs.constFind(MorphName);
+		if (morphIter != morphs.constEnd())
 		{
-			QStringList Items = MorphLine.split(",");
-			QString MorphName = Items[0].replace("\"", "");
-			if (morphs.contains(MorphName))
-			{
-				morphsToExport.append(morphs[MorphName]);
-			}
+			morphsToExport.append(morphIter.value());
 		}
 	}
 
 	RefreshExportMorphList();
 	GetActiveJointControlledMorphs();
-	file.close();
 }
 
 // Get the morph string (aka morphsToExport) in the format for the Daz FBX Export
@@ -1051,6 +1349,13 @@ QString DzBridgeMorphSelectionDialog::GetMorphLabelFromName(QString morphName)
 // DB June-01-2022, Created for MorphLinks Generation for Blender Bridge Morphs Support
 MorphInfo DzBridgeMorphSelectionDialog::GetMorphInfoFromName(QString morphName)
 {
+	EnsureMorphCatalogVerified();
+
+	if (morphsToExport.contains(morphName))
+	{
+		return morphsToExport.value(morphName);
+	}
+
 	if (morphs.isEmpty()) return MorphInfo();
 
 	if (morphs.contains(morphName))
@@ -1098,78 +1403,90 @@ bool DzBridgeMorphSelectionDialog::isValidMorph(DzProperty* pMorphProperty)
 		if (sMorphName.toLower()[0] == ignoreCondition[0])
 			return false;
 	}
-	for (auto iterator = pMorphProperty->controllerListIterator(); iterator.hasNext(); )
+	foreach(int nEdgeIndex, morphLinkGraph.getControllerEdges(pMorphProperty))
 	{
-		DzERCLink* ercLink = qobject_cast<DzERCLink*>(iterator.next());
-		if (ercLink == nullptr)
-			continue;
-		if (ercLink->getType() == 3) // Multiply
+		const MorphLinkEdge& edge = morphLinkGraph.getEdge(nEdgeIndex);
+		if (edge.Type == 3) // Multiply
 		{
-			auto controllerProperty = ercLink->getProperty();
-			if (controllerProperty && controllerProperty->getDoubleValue() == 0)
+			// controller value is read live, only the link itself is cached
+			if (edge.ControllerProperty && edge.ControllerProperty->getDoubleValue() == 0)
 				return false;
 		}
 	}
 	return true;
 }
 
-// Load morphs controlling the morphs in the export list
+// Load morphs controlled by the morphs in the export list, following the ERC links transitively.
+// Each morph is expanded once; connectedMorphsDepthLimit > 0 stops after that many links from the export list.
 void DzBridgeMorphSelectionDialog::HandleAddConnectedMorphs()
 {
+	EnsureMorphCatalogVerified();
+
 	// sanity check
 	if (morphsToExport.length() == 0)
 	{
 		return;
 	}
+
+	QQueue< QPair<DzProperty*, int> > worklist;
+	QSet<DzProperty*> visited;
 	foreach (MorphInfo exportMorph, morphsToExport)
 	{
-		DzProperty *morphProperty = exportMorph.Property;
-		if (morphProperty == nullptr)
+		if (exportMorph.Property == nullptr)
 		{
 			// log unexpected error
 			continue;
 		}
-		for (auto slaveControllerIterator = morphProperty->slaveControllerListIterator(); slaveControllerIterator.hasNext(); )
+		if (!visited.contains(exportMorph.Property))
+		{
+			visited.insert(exportMorph.Property);
+			worklist.enqueue(qMakePair(exportMorph.Property, 0));
+		}
+	}
+
+	while (!worklist.isEmpty())
+	{
+		QPair<DzProperty*, int> workItem = worklist.dequeue();
+		int nDepth = workItem.second + 1;
+		if (connectedMorphsDepthLimit > 0 && nDepth > connectedMorphsDepthLimit)
+			continue;
+
+		foreach (int nEdgeIndex, morphLinkGraph.getSlaveEdges(workItem.first))
 		{
-			DzProperty *controllerProperty = slaveControllerIterator.next()->getOwner();
+			DzProperty *controllerProperty = morphLinkGraph.getEdge(nEdgeIndex).SlaveProperty;
+			QString sMorphName = morphLinkGraph.getEdge(nEdgeIndex).SlaveName;
 			if (isValidMorph(controllerProperty)==false)
 				continue;
-			QString sMorphName = getMorphPropertyName(controllerProperty);
+			if (!morphs.contains(sMorphName))
+				continue;
 
-			// Add the list for export
-			if (morphs.contains(sMorphName) && !morphsToExport.contains(morphs[sMorphName]))
+			// Add the list for export, and expand it in turn
+			const MorphInfo& connectedMorph = morphs[sMorphName];
+			morphsToExport.append(connectedMorph);
+			if (connectedMorph.Property && !visited.contains(connectedMorph.Property))
 			{
-				morphsToExport.append(morphs[sMorphName]);
+				visited.insert(connectedMorph.Property);
+				worklist.enqueue(qMakePair(connectedMorph.Property, nDepth));
 			}
-
 		}
 	}
 	RefreshExportMorphList();
 }
+
 // Disable Morph if the morph has a controller that is also being exported
 QList<QString> DzBridgeMorphSelectionDialog::getMorphNamesToDisconnectList()
 {
 	QList<QString> morphsToDisconnect;
 
+	EnsureMorphCatalogVerified();
 	foreach (MorphInfo exportMorph, morphsToExport)
 	{
 		DzProperty* morphProperty = exportMorph.Property;
-		// DB, 2022-June-07: NOTE: using iterator may be more efficient due to potentially large number of controllers
-		for (auto iterator = morphProperty->controllerListIterator(); iterator.hasNext(); )
+		foreach (int nEdgeIndex, morphLinkGraph.getControllerEdges(morphProperty))
 		{
-			DzERCLink* ercLink = qobject_cast<DzERCLink*>(iterator.next());
-			if (ercLink == nullptr)
-				continue;
-			auto controllerProperty = ercLink->getProperty();
-			QString sControllerName = getMorphPropertyName(controllerProperty);
-			// iterate through each exported morph
-			foreach (MorphInfo compareMorph, morphsToExport)
+			if (morphsToExport.contains(morphLinkGraph.getEdge(nEdgeIndex).ControllerName))
 			{
-				if (compareMorph.Name == sControllerName)
-				{
-					morphsToDisconnect.append(exportMorph.Name);
-					break;
-				}
+				morphsToDisconnect.append(exportMorph.Name);
 			}
 		}
 	}
@@ -0,0 +1,145 @@
+#include "DzBridgeMorphTreeModel.h"
+
+using namespace DzBridgeNameSpace;
+
+DzBridgeMorphTreeModel::DzBridgeMorphTreeModel(QObject* parent) :
+	QAbstractItemModel(parent)
+{
+	m_pRoot = new TreeNode(QString(), nullptr, 0);
+}
+
+DzBridgeMorphTreeModel::~DzBridgeMorphTreeModel()
+{
+	delete m_pRoot;
+}
+
+void DzBridgeMorphTreeModel::clear()
+{
+	beginResetModel();
+	delete m_pRoot;
+	m_pRoot = new TreeNode(QString(), nullptr, 0);
+	m_aMorphs.clear();
+	endResetModel();
+}
+
+DzBridgeMorphTreeModel::TreeNode* DzBridgeMorphTreeModel::findOrAddChild(TreeNode* pParent, const QString& sName)
+{
+	TreeNode* pChild = pParent->ChildByName.value(sName, nullptr);
+	if (pChild == nullptr)
+	{
+		pChild = new TreeNode(sName, pParent, pParent->Children.count());
+		pParent->Children.append(pChild);
+		pParent->ChildByName.insert(sName, pChild);
+	}
+	return pChild;
+}
+
+void DzBridgeMorphTreeModel::setMorphs(const QMap<QString, MorphInfo>& morphs)
+{
+	beginResetModel();
+	delete m_pRoot;
+	m_pRoot = new TreeNode(QString(), nullptr, 0);
+	m_aMorphs.clear();
+	m_aMorphs.reserve(morphs.count());
+
+	for (QMap<QString, MorphInfo>::const_iterator morphIter = morphs.constBegin(); morphIter != morphs.constEnd(); ++morphIter)
+	{
+		int nMorphIndex = m_aMorphs.count();
+		m_aMorphs.append(morphIter.value());
+
+		TreeNode* pNode = m_pRoot;
+		foreach(QString pathPart, morphIter.value().Path.split("/", QString::SkipEmptyParts))
+		{
+			pNode = findOrAddChild(pNode, pathPart);
+			pNode->Morphs.append(nMorphIndex);
+		}
+	}
+
+	// top level is always visible, everything below is fetched on expand
+	m_pRoot->NumFetched = m_pRoot->Children.count();
+	endResetModel();
+}
+
+QList<MorphInfo> DzBridgeMorphTreeModel::getMorphsForIndex(const QModelIndex& index) const
+{
+	QList<MorphInfo> morphList;
+	TreeNode* pNode = nodeFromIndex(index);
+	if (pNode == nullptr || pNode == m_pRoot)
+		return morphList;
+
+	morphList.reserve(pNode->Morphs.count());
+	foreach(int nMorphIndex, pNode->Morphs)
+	{
+		morphList.append(m_aMorphs[nMorphIndex]);
+	}
+	return morphList;
+}
+
+DzBridgeMorphTreeModel::TreeNode* DzBridgeMorphTreeModel::nodeFromIndex(const QModelIndex& index) const
+{
+	if (index.isValid())
+		return static_cast<TreeNode*>(index.internalPointer());
+	return m_pRoot;
+}
+
+QModelIndex DzBridgeMorphTreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+	TreeNode* pParent = nodeFromIndex(parent);
+	if (column != 0 || row < 0 || row >= pParent->NumFetched)
+		return QModelIndex();
+	return createIndex(row, column, pParent->Children[row]);
+}
+
+QModelIndex DzBridgeMorphTreeModel::parent(const QModelIndex& index) const
+{
+	TreeNode* pNode = nodeFromIndex(index);
+	if (pNode == m_pRoot || pNode->Parent == m_pRoot)
+		return QModelIndex();
+	return createIndex(pNode->Parent->Row, 0, pNode->Parent);
+}
+
+int DzBridgeMorphTreeModel::rowCount(const QModelIndex& parent) const
+{
+	if (parent.column() > 0)
+		return 0;
+	return nodeFromIndex(parent)->NumFetched;
+}
+
+int DzBridgeMorphTreeModel::columnCount(const QModelIndex& parent) const
+{
+	return 1;
+}
+
+QVariant DzBridgeMorphTreeModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || role != Qt::DisplayRole)
+		return QVariant();
+	return nodeFromIndex(index)->Name;
+}
+
+bool DzBridgeMorphTreeModel::hasChildren(const QModelIndex& parent) const
+{
+	if (parent.column() > 0)
+		return false;
+	return !nodeFromIndex(parent)->Children.isEmpty();
+}
+
+bool DzBridgeMorphTreeModel::canFetchMore(const QModelIndex& parent) const
+{
+	TreeNode* pNode = nodeFromIndex(parent);
+	return pNode->NumFetched < pNode->Children.count();
+}
+
+void DzBridgeMorphTreeModel::fetchMore(const QModelIndex& parent)
+{
+	TreeNode* pNode = nodeFromIndex(parent);
+	int nRemaining = pNode->Children.count() - pNode->NumFetched;
+	if (nRemaining <= 0)
+		return;
+
+	beginInsertRows(parent, pNode->NumFetched, pNode->Children.count() - 1);
+	pNode->NumFetched = pNode->Children.count();
+	endInsertRows();
+}
+
+#include "moc_DzBridgeMorphTreeModel.cpp"
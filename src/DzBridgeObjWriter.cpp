@@ -0,0 +1,388 @@
+#include <QtCore/qtconcurrentmap.h>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+#include "dzfacetmesh.h"
+#include "dzmap.h"
+
+#include "DzBridgeObjWriter.h"
+
+using namespace DzBridgeNameSpace;
+
+// flush to disk once the buffer holds this many bytes
+#define OBJ_WRITER_FLUSH_SIZE (8 * 1024 * 1024)
+// vertex lines of meshes larger than this are formatted in parallel blocks of this size
+#define OBJ_WRITER_BLOCK_SIZE 16384
+// longest text of one formatFloat() call: sign, 39 integer digits of FLT_MAX, '.', 8 decimals
+#define OBJ_WRITER_MAX_FLOAT_CHARS 64
+// longest line of up to three floats: two prefix characters, the values and "\n"
+#define OBJ_WRITER_MAX_FLOAT_LINE (3 * (OBJ_WRITER_MAX_FLOAT_CHARS + 1) + 3)
+
+static char* formatInt(char* pBuffer, int nValue)
+{
+	char aDigits[12];
+	int nNumDigits = 0;
+	unsigned int nAbsValue = (nValue < 0) ? (unsigned int)(-(qint64)nValue) : (unsigned int)nValue;
+	do
+	{
+		aDigits[nNumDigits++] = '0' + (nAbsValue % 10);
+		nAbsValue /= 10;
+	} while (nAbsValue > 0);
+	if (nValue < 0)
+		*pBuffer++ = '-';
+	while (nNumDigits > 0)
+		*pBuffer++ = aDigits[--nNumDigits];
+	return pBuffer;
+}
+
+DzBridgeObjWriter::DzBridgeObjWriter()
+{
+	m_bOk = false;
+	m_bWeldSeams = false;
+	m_bRemoveUnusedVerts = true;
+	m_bWriteVT = false;
+	m_bWriteVN = false;
+	m_nFloatPrecision = 6;
+	m_bParallel = true;
+	m_nVertexOffset = 1;
+	m_nUVOffset = 1;
+	m_nNormalOffset = 1;
+}
+
+DzBridgeObjWriter::~DzBridgeObjWriter()
+{
+	if (m_File.isOpen())
+		close();
+}
+
+bool DzBridgeObjWriter::open(const QString& sFilename)
+{
+	if (m_File.isOpen())
+		close();
+
+	m_File.setFileName(sFilename);
+	m_bOk = m_File.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	m_Buffer.clear();
+	m_Buffer.reserve(OBJ_WRITER_FLUSH_SIZE + OBJ_WRITER_FLUSH_SIZE / 4);
+	m_nVertexOffset = 1;
+	m_nUVOffset = 1;
+	m_nNormalOffset = 1;
+
+	return m_bOk;
+}
+
+bool DzBridgeObjWriter::close()
+{
+	if (m_File.isOpen())
+	{
+		flush(true);
+		m_File.close();
+	}
+	m_Buffer.clear();
+
+	return m_bOk;
+}
+
+void DzBridgeObjWriter::flush(bool bForce)
+{
+	if (m_Buffer.isEmpty() || (bForce == false && m_Buffer.size() < OBJ_WRITER_FLUSH_SIZE))
+		return;
+
+	if (m_bOk && m_File.write(m_Buffer) != m_Buffer.size())
+		m_bOk = false;
+	m_Buffer.resize(0);
+}
+
+char* DzBridgeObjWriter::formatFloat(char* pBuffer, float fValue, int nPrecision)
+{
+	static const quint64 aScale[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL };
+	nPrecision = qBound(0, nPrecision, 8);
+
+	double dValue = fValue;
+	// exact for float inputs: 10^8 = 2^8 * 5^8, and the 24 bit mantissa times 5^8 (19 bits) fits in
+	// the 53 bit mantissa of a double, so the rounding below sees the true remainder
+	double dScaled = fabs(dValue) * aScale[nPrecision];
+	if (dValue != dValue || dScaled >= 9.0e18)
+	{
+		// NaN, infinity or out of range for the integer path, rare enough to leave to the C library
+		return pBuffer + qsnprintf(pBuffer, OBJ_WRITER_MAX_FLOAT_CHARS, "%.*f", nPrecision, dValue);
+	}
+
+	// round half to even, matching printf("%.6f")
+	double dFloor = floor(dScaled);
+	quint64 nScaled = (quint64)dFloor;
+	double dRemainder = dScaled - dFloor;
+	if (dRemainder > 0.5 || (dRemainder == 0.5 && (nScaled & 1)))
+		nScaled++;
+	// printf keeps the sign of -0.0 and of negative values that round to zero
+	if (signbit(dValue))
+		*pBuffer++ = '-';
+
+	quint64 nIntPart = nScaled / aScale[nPrecision];
+	quint64 nFracPart = nScaled % aScale[nPrecision];
+
+	char aDigits[24];
+	int nNumDigits = 0;
+	do
+	{
+		aDigits[nNumDigits++] = '0' + (char)(nIntPart % 10);
+		nIntPart /= 10;
+	} while (nIntPart > 0);
+	while (nNumDigits > 0)
+		*pBuffer++ = aDigits[--nNumDigits];
+
+	if (nPrecision > 0)
+	{
+		*pBuffer++ = '.';
+		for (int i = nPrecision - 1; i >= 0; i--)
+		{
+			pBuffer[i] = '0' + (char)(nFracPart % 10);
+			nFracPart /= 10;
+		}
+		pBuffer += nPrecision;
+	}
+
+	return pBuffer;
+}
+
+void DzBridgeObjWriter::appendLine(char cPrefix0, char cPrefix1, const float* pValues, int nNumValues)
+{
+	char aLine[OBJ_WRITER_MAX_FLOAT_LINE];
+	char* p = aLine;
+	*p++ = cPrefix0;
+	if (cPrefix1)
+		*p++ = cPrefix1;
+	for (int i = 0; i < nNumValues; i++)
+	{
+		*p++ = ' ';
+		p = formatFloat(p, pValues[i], m_nFloatPrecision);
+	}
+	*p++ = '\n';
+	m_Buffer.append(aLine, (int)(p - aLine));
+}
+
+void DzBridgeObjWriter::formatVertexBlock(QByteArray& block, const float* pPositions, const QVector<int>& aOutputVertices, int nBegin, int nEnd) const
+{
+	// sized for typical lines, grown when a line of huge values would not fit
+	block.resize((nEnd - nBegin) * 48 + OBJ_WRITER_MAX_FLOAT_LINE);
+	char* pStart = block.data();
+	char* p = pStart;
+	for (int i = nBegin; i < nEnd; i++)
+	{
+		if (block.size() - (int)(p - pStart) < OBJ_WRITER_MAX_FLOAT_LINE)
+		{
+			int nUsed = (int)(p - pStart);
+			block.resize(block.size() * 2);
+			pStart = block.data();
+			p = pStart + nUsed;
+		}
+		const float* pVertex = pPositions + aOutputVertices[i] * 3;
+		*p++ = 'v';
+		for (int c = 0; c < 3; c++)
+		{
+			*p++ = ' ';
+			p = formatFloat(p, pVertex[c], m_nFloatPrecision);
+		}
+		*p++ = '\n';
+	}
+	block.resize((int)(p - pStart));
+}
+
+bool DzBridgeObjWriter::writeMesh(DzFacetMesh* pMesh)
+{
+	if (m_bOk == false || pMesh == nullptr)
+		return false;
+
+	int nNumVerts = pMesh->getNumVertices();
+	const float* pPositions = (const float*)pMesh->getVertexArray();
+	int nNumFacets = pMesh->getNumFacets();
+	const DzFacet* pFacets = pMesh->getFacetsPtr();
+	if (nNumVerts <= 0 || pPositions == nullptr)
+		return false;
+	if (pFacets == nullptr)
+		nNumFacets = 0;
+
+	// WeldSeams: every vertex points to the lowest index vertex at the same position
+	QVector<int> aWeld(nNumVerts);
+	for (int i = 0; i < nNumVerts; i++)
+		aWeld[i] = i;
+	if (m_bWeldSeams)
+	{
+		QVector<int> aSorted = aWeld;
+		std::sort(aSorted.begin(), aSorted.end(), [pPositions](int a, int b) {
+			const float* pA = pPositions + a * 3;
+			const float* pB = pPositions + b * 3;
+			if (pA[0] != pB[0]) return pA[0] < pB[0];
+			if (pA[1] != pB[1]) return pA[1] < pB[1];
+			if (pA[2] != pB[2]) return pA[2] < pB[2];
+			return a < b;
+		});
+		for (int i = 1; i < nNumVerts; i++)
+		{
+			const float* pA = pPositions + aSorted[i - 1] * 3;
+			const float* pB = pPositions + aSorted[i] * 3;
+			if (pA[0] == pB[0] && pA[1] == pB[1] && pA[2] == pB[2])
+				aWeld[aSorted[i]] = aWeld[aSorted[i - 1]];
+		}
+	}
+
+	// RemoveUnusedVerts: only vertices referenced by a facet are written
+	QVector<char> aUsed(nNumVerts, m_bRemoveUnusedVerts ? 0 : 1);
+	for (int nFacet = 0; nFacet < nNumFacets; nFacet++)
+	{
+		int nCorners = pFacets[nFacet].isQuad() ? 4 : 3;
+		for (int j = 0; j < nCorners; j++)
+			aUsed[aWeld[pFacets[nFacet].m_vertIdx[j]]] = 1;
+	}
+
+	// aWeld[i] <= i, so the representative is always numbered before its duplicates
+	QVector<int> aOutputIndex(nNumVerts, -1);
+	QVector<int> aOutputVertices;
+	aOutputVertices.reserve(nNumVerts);
+	for (int i = 0; i < nNumVerts; i++)
+	{
+		if (aWeld[i] != i)
+		{
+			aOutputIndex[i] = aOutputIndex[aWeld[i]];
+		}
+		else if (aUsed[i])
+		{
+			aOutputIndex[i] = aOutputVertices.count();
+			aOutputVertices.append(i);
+		}
+	}
+	int nNumOutputVerts = aOutputVertices.count();
+
+	// v
+	if (m_bParallel && nNumOutputVerts > OBJ_WRITER_BLOCK_SIZE * 2)
+	{
+		struct VertexBlock
+		{
+			int Begin;
+			int End;
+			QByteArray Text;
+		};
+		QVector<VertexBlock> aBlocks;
+		for (int nBegin = 0; nBegin < nNumOutputVerts; nBegin += OBJ_WRITER_BLOCK_SIZE)
+		{
+			VertexBlock block;
+			block.Begin = nBegin;
+			block.End = qMin(nBegin + OBJ_WRITER_BLOCK_SIZE, nNumOutputVerts);
+			aBlocks.append(block);
+		}
+		QtConcurrent::blockingMap(aBlocks, [this, pPositions, &aOutputVertices](VertexBlock& block) {
+			formatVertexBlock(block.Text, pPositions, aOutputVertices, block.Begin, block.End);
+		});
+		foreach(const VertexBlock& block, aBlocks)
+		{
+			m_Buffer.append(block.Text);
+			flush(false);
+		}
+	}
+	else
+	{
+		QByteArray block;
+		formatVertexBlock(block, pPositions, aOutputVertices, 0, nNumOutputVerts);
+		m_Buffer.append(block);
+		flush(false);
+	}
+
+	// vt
+	int nNumUVs = 0;
+	if (m_bWriteVT)
+	{
+		DzMap* pUVMap = pMesh->getUVs();
+		const DzPnt2* pUVs = pUVMap ? pUVMap->getPnt2ArrayPtr() : nullptr;
+		if (pUVs)
+		{
+			nNumUVs = pUVMap->getNumValues();
+			for (int i = 0; i < nNumUVs; i++)
+			{
+				appendLine('v', 't', pUVs[i], 2);
+				flush(false);
+			}
+		}
+	}
+
+	// vn, area weighted average of the facet normals around each written vertex
+	if (m_bWriteVN)
+	{
+		QVector<float> aNormals(nNumOutputVerts * 3, 0.0f);
+		for (int nFacet = 0; nFacet < nNumFacets; nFacet++)
+		{
+			const DzFacet& facet = pFacets[nFacet];
+			int nCorners = facet.isQuad() ? 4 : 3;
+			const float* p0 = pPositions + facet.m_vertIdx[0] * 3;
+			float aFacetNormal[3] = { 0.0f, 0.0f, 0.0f };
+			for (int j = 1; j + 1 < nCorners; j++)
+			{
+				const float* p1 = pPositions + facet.m_vertIdx[j] * 3;
+				const float* p2 = pPositions + facet.m_vertIdx[j + 1] * 3;
+				float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				aFacetNormal[0] += e1[1] * e2[2] - e1[2] * e2[1];
+				aFacetNormal[1] += e1[2] * e2[0] - e1[0] * e2[2];
+				aFacetNormal[2] += e1[0] * e2[1] - e1[1] * e2[0];
+			}
+			for (int j = 0; j < nCorners; j++)
+			{
+				float* pNormal = aNormals.data() + aOutputIndex[facet.m_vertIdx[j]] * 3;
+				pNormal[0] += aFacetNormal[0];
+				pNormal[1] += aFacetNormal[1];
+				pNormal[2] += aFacetNormal[2];
+			}
+		}
+		for (int i = 0; i < nNumOutputVerts; i++)
+		{
+			float* pNormal = aNormals.data() + i * 3;
+			float fLength = sqrt(pNormal[0] * pNormal[0] + pNormal[1] * pNormal[1] + pNormal[2] * pNormal[2]);
+			if (fLength > 0.0f)
+			{
+				pNormal[0] /= fLength;
+				pNormal[1] /= fLength;
+				pNormal[2] /= fLength;
+			}
+			appendLine('v', 'n', pNormal, 3);
+			flush(false);
+		}
+	}
+
+	// f
+	char aLine[256];
+	for (int nFacet = 0; nFacet < nNumFacets; nFacet++)
+	{
+		const DzFacet& facet = pFacets[nFacet];
+		int nCorners = facet.isQuad() ? 4 : 3;
+		char* p = aLine;
+		*p++ = 'f';
+		for (int j = 0; j < nCorners; j++)
+		{
+			int nVertex = aOutputIndex[facet.m_vertIdx[j]];
+			*p++ = ' ';
+			p = formatInt(p, m_nVertexOffset + nVertex);
+			if (nNumUVs > 0)
+			{
+				*p++ = '/';
+				p = formatInt(p, m_nUVOffset + facet.m_uvwIdx[j]);
+			}
+			if (m_bWriteVN)
+			{
+				if (nNumUVs == 0)
+					*p++ = '/';
+				*p++ = '/';
+				p = formatInt(p, m_nNormalOffset + nVertex);
+			}
+		}
+		*p++ = '\n';
+		m_Buffer.append(aLine, (int)(p - aLine));
+		flush(false);
+	}
+
+	m_nVertexOffset += nNumOutputVerts;
+	m_nUVOffset += nNumUVs;
+	if (m_bWriteVN)
+		m_nNormalOffset += nNumOutputVerts;
+
+	return m_bOk;
+}
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <QtCore/qfile.h>
+
+#include "DzBridgeZipWriter.h"
+#include "zip.h"
+
+using namespace DzBridgeNameSpace;
+
+// DzJsonWriter produces many small writes, collect them before compressing
+static const int s_nZipWriteBlockSize = 256 * 1024;
+
+DzBridgeZipWriter::DzBridgeZipWriter(QString sZipFilename, QString sEntryName, int nCompressionLevel)
+{
+	m_sZipFilename = sZipFilename;
+	m_sEntryName = sEntryName;
+	m_nCompressionLevel = nCompressionLevel;
+	m_pZip = nullptr;
+}
+
+DzBridgeZipWriter::~DzBridgeZipWriter()
+{
+	close();
+}
+
+bool DzBridgeZipWriter::open(OpenMode mode)
+{
+	if (mode != QIODevice::WriteOnly || m_pZip != nullptr)
+	{
+		setErrorString("DzBridgeZipWriter only supports QIODevice::WriteOnly");
+		return false;
+	}
+
+	QFile::remove(m_sZipFilename);
+	m_pZip = ::zip_open(QFile::encodeName(m_sZipFilename).constData(), m_nCompressionLevel, 'w');
+	if (m_pZip == nullptr)
+	{
+		setErrorString("Unable to create zip file: " + m_sZipFilename);
+		return false;
+	}
+	if (::zip_entry_open(m_pZip, m_sEntryName.toUtf8().constData()) != 0)
+	{
+		::zip_close(m_pZip);
+		m_pZip = nullptr;
+		setErrorString("Unable to create zip entry: " + m_sEntryName);
+		return false;
+	}
+	m_Buffer.clear();
+	m_Buffer.reserve(s_nZipWriteBlockSize);
+
+	return QIODevice::open(mode);
+}
+
+void DzBridgeZipWriter::close()
+{
+	if (m_pZip == nullptr)
+		return;
+
+	flushBuffer();
+	::zip_entry_close(m_pZip);
+	::zip_close(m_pZip);
+	m_pZip = nullptr;
+
+	QIODevice::close();
+}
+
+qint64 DzBridgeZipWriter::readData(char* data, qint64 maxSize)
+{
+	return -1;
+}
+
+qint64 DzBridgeZipWriter::writeData(const char* data, qint64 maxSize)
+{
+	if (m_pZip == nullptr)
+		return -1;
+
+	m_Buffer.append(data, maxSize);
+	if (m_Buffer.size() >= s_nZipWriteBlockSize)
+	{
+		if (flushBuffer() == false)
+			return -1;
+	}
+
+	return maxSize;
+}
+
+bool DzBridgeZipWriter::flushBuffer()
+{
+	if (m_pZip == nullptr || m_Buffer.isEmpty())
+		return true;
+
+	int nResult = ::zip_entry_write(m_pZip, m_Buffer.constData(), m_Buffer.size());
+	m_Buffer.resize(0);
+	if (nResult != 0)
+	{
+		setErrorString(QString("Unable to write zip entry: ") + ::zip_strerror(nResult));
+		return false;
+	}
+
+	return true;
+}
+
+bool DzBridgeZipWriter::isZipFile(QString sFilename)
+{
+	QFile file(sFilename);
+	if (file.open(QIODevice::ReadOnly) == false)
+		return false;
+
+	QByteArray header = file.read(4);
+	file.close();
+
+	return header == QByteArray("PK\x03\x04", 4);
+}
+
+QByteArray DzBridgeZipWriter::readFirstEntry(QString sZipFilename)
+{
+	QByteArray contents;
+	struct zip_t* zip = ::zip_open(QFile::encodeName(sZipFilename).constData(), 0, 'r');
+	if (zip == nullptr)
+		return contents;
+
+	if (::zip_entry_openbyindex(zip, 0) == 0)
+	{
+		void* buffer = nullptr;
+		size_t bufferSize = 0;
+		if (::zip_entry_read(zip, &buffer, &bufferSize) >= 0 && buffer)
+		{
+			contents = QByteArray((const char*)buffer, (int)bufferSize);
+		}
+		free(buffer);
+		::zip_entry_close(zip);
+	}
+	::zip_close(zip);
+
+	return contents;
+}
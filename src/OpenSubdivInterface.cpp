@@ -32,9 +32,20 @@ SOFTWARE.
 
 #include <iostream>
 #include <map>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include <QtCore/qfile.h>
+#include <QtCore/qtconcurrentmap.h>
 
 #include <opensubdiv/far/topologyDescriptor.h>
-#include <opensubdiv/far/primvarRefiner.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/osd/bufferDescriptor.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
 
 #include "OpenFBXInterface.h"
 #include "OpenSubdivInterface.h"
@@ -42,6 +53,16 @@ SOFTWARE.
 
 bool SubdivideFbxScene::ProcessScene()
 {
+	m_SubdivisionTasks.clear();
+	m_MeshTimings.clear();
+	m_nCacheHits = 0;
+	m_nCacheMisses = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_TopologyMutex);
+		m_Topology_NameLookup.clear();
+		m_fCacheMillisecondsSaved = 0.0;
+	}
+
 	FbxNode* pNode = m_Scene->GetRootNode();
 	if (pNode)
 	{
@@ -58,6 +79,22 @@ bool SubdivideFbxScene::ProcessScene()
 		return false;
 	}
 
+	// meshes are independent: subdivide them concurrently, each task with its own buffers
+	QtConcurrent::blockingMap(m_SubdivisionTasks, [this](SubdivisionTask& task)
+	{
+		auto start = std::chrono::steady_clock::now();
+		task.Result = SubdivideMesh(task.Node, task.Mesh, task.SubDLevel);
+		task.Timing.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		task.Timing.FineVerts = task.Result ? task.Result->GetControlPointsCount() : 0;
+	});
+
+	for (const SubdivisionTask& task : m_SubdivisionTasks)
+	{
+		m_FbxMesh_NameLookup[task.Timing.Name] = task.Result;
+		m_MeshTimings.push_back(task.Timing);
+	}
+	m_SubdivisionTasks.clear();
+
 	return true;
 }
 
@@ -85,7 +122,18 @@ bool SubdivideFbxScene::ProcessNode(FbxNode* pNode)
 			}
 			if (nodeSubDLevel > 0)
 			{
-				m_FbxMesh_NameLookup[name] = SubdivideMesh(pNode, (FbxMesh*)pNode->GetNodeAttribute(), nodeSubDLevel);
+				// subdivided later by ProcessScene()
+				SubdivisionTask task;
+				task.Node = pNode;
+				task.Mesh = (FbxMesh*)pNode->GetNodeAttribute();
+				task.SubDLevel = nodeSubDLevel;
+				task.Result = nullptr;
+				task.Timing.Name = name;
+				task.Timing.SubDLevel = nodeSubDLevel;
+				task.Timing.CoarseVerts = task.Mesh->GetControlPointsCount();
+				task.Timing.FineVerts = 0;
+				task.Timing.Milliseconds = 0.0;
+				m_SubdivisionTasks.push_back(task);
 			}
 			break;
 		}
@@ -139,130 +187,87 @@ FbxMesh* SubdivideFbxScene::SubdivideMesh(FbxNode* pNode, FbxMesh* pMesh, int su
 		}
 	}
 
-	// OpenSubdiv topology descriptor
-	typedef OpenSubdiv::Far::TopologyDescriptor Descriptor;
-	OpenSubdiv::Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
-	OpenSubdiv::Sdc::Options options;
-	options.SetVtxBoundaryInterpolation(OpenSubdiv::Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
-
-	Descriptor desc;
-	desc.numVertices = numVertices;
-	desc.numFaces = numFaces;
-	desc.numVertsPerFace = numVertsPerFace.data();
-	desc.vertIndicesPerFace = vertIndicesPerFace.data();
-
-	// Make topology refiner
-	OpenSubdiv::Far::TopologyRefiner* refiner = OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Create(
-		desc,
-		OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Options(type, options)
-	);
-
-	// Refine topology
-	refiner->RefineUniform(OpenSubdiv::Far::TopologyRefiner::UniformOptions(subdLevel));
-
-	// calculate number of additional vertices
-	int nCoarseVerts = numVertices;
-	int nFineVerts = refiner->GetLevel(subdLevel).GetNumVertices();
-	int nTotalVerts = refiner->GetNumVerticesTotal();
-	int nTempVerts = nTotalVerts - nCoarseVerts - nFineVerts;
-
-	// allocate storage for additional vertices
-	std::vector<VertexPosition> tempPosBuffer(nTempVerts);
-	std::vector<VertexPosition> finePosBuffer(nFineVerts);
+	// Refined topology and stencil table, shared by all meshes with the same topology
+	std::shared_ptr<SubdivisionTopology> topology = GetOrCreateTopology(numVertsPerFace, vertIndicesPerFace, numVertices, subdLevel);
+	if (!topology)
+		return nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_TopologyMutex);
+		m_Topology_NameLookup[pNode->GetName()] = topology;
+	}
+	int nCoarseVerts = topology->NumCoarseVerts;
+	int nFineVerts = topology->NumFineVerts;
 
-	// get vertex data from source mesh
-	std::vector<VertexPosition> coarsePosBuffer(nCoarseVerts);
+	// get vertex data from source mesh and refine it
+	std::vector<float> coarsePosBuffer((size_t)nCoarseVerts * 3);
+	std::vector<float> finePosBuffer((size_t)nFineVerts * 3);
 	FbxVector4* nControlPoints = pMesh->GetControlPoints();
 	for (int i = 0; i < nCoarseVerts; i++)
 	{
-		coarsePosBuffer[i].SetVector(nControlPoints[i]);
+		coarsePosBuffer[i * 3 + 0] = (float)nControlPoints[i][0];
+		coarsePosBuffer[i * 3 + 1] = (float)nControlPoints[i][1];
+		coarsePosBuffer[i * 3 + 2] = (float)nControlPoints[i][2];
 	}
+	topology->Refine(coarsePosBuffer.data(), finePosBuffer.data(), 3);
 
-	VertexPosition *srcPos = &coarsePosBuffer[0];
-	VertexPosition *dstPos = &tempPosBuffer[0];
-	
-	// Make Primvar::refiner from topology refiner
-	OpenSubdiv::Far::PrimvarRefiner primvarRefiner(*refiner);
-
-	// Do intermediate interpolation steps
-	for (int level = 1; level < subdLevel; ++level)
+	// Interpolate the skin weights of every cluster into its own sparse list of fine vertices
+	FbxGeometry* pGeometry = pMesh;
+	int lSkinCount = pGeometry->GetDeformerCount(FbxDeformer::eSkin);
+	std::vector<std::vector<ClusterWeights>> skinClusterWeights(lSkinCount);
+	std::vector<ClusterWeights*> allClusterWeights;
+	for (int i = 0; i != lSkinCount; ++i)
 	{
-		primvarRefiner.Interpolate(level, srcPos, dstPos);
-		srcPos = dstPos, dstPos += refiner->GetLevel(level).GetNumVertices();
+		FbxSkin* pSkin = (FbxSkin*)pGeometry->GetDeformer(i, FbxDeformer::eSkin);
+		int lClusterCount = pSkin->GetClusterCount();
+		skinClusterWeights[i].resize(lClusterCount);
+		for (int j = 0; j != lClusterCount; ++j)
+		{
+			skinClusterWeights[i][j].SourceCluster = pSkin->GetCluster(j);
+			allClusterWeights.push_back(&skinClusterWeights[i][j]);
+		}
 	}
+	if (m_bSparseSkinWeights)
+		InterpolateSkinWeightsSparse(*topology, allClusterWeights);
+	else
+		InterpolateSkinWeights(*topology, allClusterWeights);
 
-	// Do last Interpolation into buffer for final data
-	primvarRefiner.Interpolate(subdLevel, srcPos, finePosBuffer);
+	// FbxScene is not thread safe: object creation is serialized across meshes
+	std::lock_guard<std::mutex> lock(m_FbxSceneMutex);
 
 	// Create FBX mesh to store subdivided data
 	FbxString meshName = FbxString(pNode->GetName()) + FbxString("_subd");
 	FbxMesh* mesh = FbxMesh::Create(m_Scene, meshName);
-	OpenSubdiv::Far::TopologyLevel topo = refiner->GetLevel(subdLevel);
 	mesh->InitControlPoints(nFineVerts);
 	FbxVector4* pControlPoints = mesh->GetControlPoints();
 	for (int vert_index = 0; vert_index < nFineVerts; ++vert_index)
 	{
-		pControlPoints[vert_index] = finePosBuffer[vert_index].GetVector();
+		pControlPoints[vert_index] = FbxVector4(finePosBuffer[vert_index * 3 + 0], finePosBuffer[vert_index * 3 + 1], finePosBuffer[vert_index * 3 + 2], 1.0f);
 	}
-	int numSubDFaces = topo.GetNumFaces();
+	int numSubDFaces = (int)topology->FineFaceOffsets.size() - 1;
 	for (int i = 0; i < numSubDFaces; i++)
 	{
-		OpenSubdiv::Far::ConstIndexArray faceVertices = topo.GetFaceVertices(i);
 		mesh->BeginPolygon(-1, -1, false);
-		for (int j = 0; j < faceVertices.size(); j++)
+		for (int j = topology->FineFaceOffsets[i]; j < topology->FineFaceOffsets[i + 1]; j++)
 		{
-			mesh->AddPolygon(faceVertices[j]);
+			mesh->AddPolygon(topology->FineFaceVertices[j]);
 		}
 		mesh->EndPolygon();
 	}
 
-	// Get cluster and skin weight data from FBX geometry links and interplate them
-	FbxGeometry* pGeometry = pMesh;
-	int lSkinCount = pGeometry->GetDeformerCount(FbxDeformer::eSkin);
+	// Save the interpolated skin weights to new clusters
 	for (int i = 0; i != lSkinCount; ++i)
 	{
 		FbxSkin* skin = FbxSkin::Create(m_Scene, "");
-		int lClusterCount = ((FbxSkin*)pGeometry->GetDeformer(i, FbxDeformer::eSkin))->GetClusterCount();
-		for (int j = 0; j != lClusterCount; ++j)
+		for (const ClusterWeights& clusterWeights : skinClusterWeights[i])
 		{
-			// get cluster data from FBX
-			FbxCluster* lCluster = ((FbxSkin*)pGeometry->GetDeformer(i, FbxDeformer::eSkin))->GetCluster(j);
-			const char* lClusterModes[] = { "Normalize", "Additive", "Total1" };
-
-			int lIndexCount = lCluster->GetControlPointIndicesCount();
-			int* lIndices = lCluster->GetControlPointIndices();
-			double* lWeights = lCluster->GetControlPointWeights();
-
-			// populate coarse skin weight buffer
-			std::vector<SkinWeight>    coarseSkinWeightBuffer(nCoarseVerts);
-			for (int k = 0; k < lIndexCount; k++)
-				coarseSkinWeightBuffer[lIndices[k]].SetWeight((float)lWeights[k]);
-
-			// Allocate intermediate and final storage to be populated:
-			std::vector<SkinWeight> tempSkinWeightBuffer(nTempVerts);
-			std::vector<SkinWeight> fineSkinWeightBuffer(nFineVerts);
-
-			// interpolate skin weights
-			SkinWeight* src = &coarseSkinWeightBuffer[0];
-			SkinWeight* dst = &tempSkinWeightBuffer[0];
-			for (int level = 1; level < subdLevel; ++level)
-			{
-				primvarRefiner.Interpolate(level, src, dst);
-				src = dst, dst += refiner->GetLevel(level).GetNumVertices();
-			}
-
-			// Interpolate the last level into the separate buffers for our final data:
-			primvarRefiner.Interpolate(subdLevel, src, fineSkinWeightBuffer);
-
 			// save cluster data
+			FbxCluster* lCluster = clusterWeights.SourceCluster;
 			FbxCluster* cluster = FbxCluster::Create(m_Scene, lCluster->GetName());
 			cluster->SetLink(lCluster->GetLink());
 			cluster->SetLinkMode(lCluster->GetLinkMode());
-			for (int k = 0; k < nFineVerts; k++)
+			for (size_t k = 0; k < clusterWeights.Indices.size(); k++)
 			{
-				float weight = fineSkinWeightBuffer[k].GetWeight();
-				if (weight > 0.0f)
-					cluster->AddControlPointIndex(k, weight);
+				cluster->AddControlPointIndex(clusterWeights.Indices[k], clusterWeights.Weights[k]);
 			}
 
 			// copy matrix
@@ -281,6 +286,471 @@ FbxMesh* SubdivideFbxScene::SubdivideMesh(FbxNode* pNode, FbxMesh* pMesh, int su
 	return mesh;
 }
 
+void SubdivisionTopology::BuildCoarseToFine()
+{
+	std::vector<int> const& stencilSizes = StencilSizes;
+	std::vector<int> const& stencilOffsets = StencilOffsets;
+	std::vector<int> const& stencilIndices = StencilIndices;
+
+	CoarseToFineOffsets.assign(NumCoarseVerts + 1, 0);
+	for (size_t k = 0; k < stencilIndices.size(); k++)
+		CoarseToFineOffsets[stencilIndices[k] + 1]++;
+	for (int v = 0; v < NumCoarseVerts; v++)
+		CoarseToFineOffsets[v + 1] += CoarseToFineOffsets[v];
+	CoarseToFine.resize(stencilIndices.size());
+	std::vector<int> coarseToFineFill(CoarseToFineOffsets.begin(), CoarseToFineOffsets.end() - 1);
+	for (int nFineVert = 0; nFineVert < NumFineVerts; nFineVert++)
+	{
+		for (int k = stencilOffsets[nFineVert]; k < stencilOffsets[nFineVert] + stencilSizes[nFineVert]; k++)
+			CoarseToFine[coarseToFineFill[stencilIndices[k]]++] = nFineVert;
+	}
+}
+
+void SubdivisionTopology::Refine(const float* pCoarse, float* pFine, int nElements) const
+{
+	if (NumFineVerts == 0 || (int)StencilSizes.size() != NumFineVerts)
+		return;
+
+	// blocks of stencils are independent: evaluate them with the CPU kernel on the global thread pool
+	const int nBlockSize = 4096;
+	std::vector<int> blockStarts;
+	for (int nStart = 0; nStart < NumFineVerts; nStart += nBlockSize)
+		blockStarts.push_back(nStart);
+
+	OpenSubdiv::Osd::BufferDescriptor srcDesc(0, nElements, nElements);
+	const int* pSizes = StencilSizes.data();
+	const int* pOffsets = StencilOffsets.data();
+	const int* pIndices = StencilIndices.data();
+	const float* pWeights = StencilWeights.data();
+	int nNumFineVerts = NumFineVerts;
+	QtConcurrent::blockingMap(blockStarts, [=](int nStart)
+	{
+		// the kernel writes stencil nStart + i to dst + offset + i * stride, so each block offsets dst to its first vertex
+		OpenSubdiv::Osd::BufferDescriptor dstDesc(nStart * nElements, nElements, nElements);
+		OpenSubdiv::Osd::CpuEvaluator::EvalStencils(pCoarse, srcDesc, pFine, dstDesc,
+			pSizes, pOffsets, pIndices, pWeights, nStart, std::min(nStart + nBlockSize, nNumFineVerts));
+	});
+}
+
+namespace
+{
+	// QFile takes the UTF-8 path as a QString, so non-ANSI folders also work on Windows
+	QString toFilePath(const std::string& sFilename)
+	{
+		return QString::fromUtf8(sFilename.c_str());
+	}
+
+	bool writeBytes(QFile& file, const void* pData, qint64 nBytes)
+	{
+		return file.write((const char*)pData, nBytes) == nBytes;
+	}
+
+	bool readBytes(QFile& file, void* pData, qint64 nBytes)
+	{
+		return file.read((char*)pData, nBytes) == nBytes;
+	}
+
+	template <typename T> bool writeArray(QFile& file, const std::vector<T>& values)
+	{
+		uint32_t nCount = (uint32_t)values.size();
+		return writeBytes(file, &nCount, sizeof(nCount)) && (nCount == 0 || writeBytes(file, values.data(), (qint64)nCount * sizeof(T)));
+	}
+
+	template <typename T> bool readArray(QFile& file, std::vector<T>& values, uint64_t nMaxCount)
+	{
+		uint32_t nCount = 0;
+		if (!readBytes(file, &nCount, sizeof(nCount)) || nCount > nMaxCount)
+			return false;
+		values.resize(nCount);
+		return nCount == 0 || readBytes(file, values.data(), (qint64)nCount * sizeof(T));
+	}
+}
+
+bool SubdivisionTopology::Save(const std::string& sFilename, const std::string& sKey) const
+{
+	QFile file(toFilePath(sFilename));
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	uint32_t nVersion = 1;
+	uint32_t nKeyLength = (uint32_t)sKey.size();
+	int32_t aHeader[3] = { SubDLevel, NumCoarseVerts, NumFineVerts };
+	bool bOk = writeBytes(file, "DZST", 4) &&
+		writeBytes(file, &nVersion, sizeof(nVersion)) &&
+		writeBytes(file, &nKeyLength, sizeof(nKeyLength)) &&
+		writeBytes(file, sKey.data(), nKeyLength) &&
+		writeBytes(file, aHeader, sizeof(aHeader)) &&
+		writeBytes(file, &BuildMilliseconds, sizeof(BuildMilliseconds)) &&
+		writeArray(file, FineFaceOffsets) &&
+		writeArray(file, FineFaceVertices) &&
+		writeArray(file, StencilSizes) &&
+		writeArray(file, StencilOffsets) &&
+		writeArray(file, StencilIndices) &&
+		writeArray(file, StencilWeights);
+	bOk = file.flush() && bOk;
+	file.close();
+	return bOk;
+}
+
+bool SubdivisionTopology::Load(const std::string& sFilename, const std::string& sKey)
+{
+	QFile file(toFilePath(sFilename));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	uint64_t nFileSize = (uint64_t)file.size();
+
+	char magic[4];
+	uint32_t nVersion = 0;
+	uint32_t nKeyLength = 0;
+	if (!readBytes(file, magic, 4) || memcmp(magic, "DZST", 4) != 0)
+		return false;
+	if (!readBytes(file, &nVersion, sizeof(nVersion)) || nVersion != 1)
+		return false;
+	if (!readBytes(file, &nKeyLength, sizeof(nKeyLength)) || nKeyLength != sKey.size())
+		return false;
+	std::string sFileKey(nKeyLength, '\0');
+	if (nKeyLength > 0 && !readBytes(file, &sFileKey[0], nKeyLength))
+		return false;
+	if (sFileKey != sKey)
+		return false;
+
+	int32_t aHeader[3];
+	if (!readBytes(file, aHeader, sizeof(aHeader)) || !readBytes(file, &BuildMilliseconds, sizeof(BuildMilliseconds)))
+		return false;
+	SubDLevel = aHeader[0];
+	NumCoarseVerts = aHeader[1];
+	NumFineVerts = aHeader[2];
+
+	uint64_t nMaxCount = nFileSize / 4;
+	if (!readArray(file, FineFaceOffsets, nMaxCount) || !readArray(file, FineFaceVertices, nMaxCount) ||
+		!readArray(file, StencilSizes, nMaxCount) || !readArray(file, StencilOffsets, nMaxCount) ||
+		!readArray(file, StencilIndices, nMaxCount) || !readArray(file, StencilWeights, nMaxCount))
+		return false;
+
+	// reject files that would index out of range
+	if (NumFineVerts < 0 || (int)StencilSizes.size() != NumFineVerts || StencilOffsets.size() != StencilSizes.size() ||
+		StencilIndices.size() != StencilWeights.size() || FineFaceOffsets.empty() || FineFaceOffsets[0] != 0 ||
+		(size_t)FineFaceOffsets.back() != FineFaceVertices.size())
+		return false;
+	for (size_t i = 1; i < FineFaceOffsets.size(); i++)
+	{
+		if (FineFaceOffsets[i] < FineFaceOffsets[i - 1])
+			return false;
+	}
+	for (int i = 0; i < NumFineVerts; i++)
+	{
+		if (StencilOffsets[i] < 0 || StencilSizes[i] < 0 || (size_t)StencilOffsets[i] + StencilSizes[i] > StencilIndices.size())
+			return false;
+	}
+	for (int nIndex : StencilIndices)
+	{
+		if (nIndex < 0 || nIndex >= NumCoarseVerts)
+			return false;
+	}
+	for (int nIndex : FineFaceVertices)
+	{
+		if (nIndex < 0 || nIndex >= NumFineVerts)
+			return false;
+	}
+	CoarseToFineOffsets.clear();
+	CoarseToFine.clear();
+	return true;
+}
+
+std::string SubdivideFbxScene::GetTopologyKey(const std::vector<int>& numVertsPerFace, const std::vector<int>& vertIndicesPerFace, int numVertices, int subdLevel)
+{
+	// FNV-1a over the face sizes and face-vertex indices
+	uint64_t hash = 14695981039346656037ULL;
+	auto hashInt = [&hash](int value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			hash ^= (uint64_t)((value >> (i * 8)) & 0xff);
+			hash *= 1099511628211ULL;
+		}
+	};
+	for (int value : numVertsPerFace)
+		hashInt(value);
+	for (int value : vertIndicesPerFace)
+		hashInt(value);
+
+	// scheme and boundary options are fixed in CreateTopology(), bump the "catmark-edge1" tag if they change
+	char key[128];
+	snprintf(key, sizeof(key), "catmark-edge1_L%d_V%d_F%d_%016llx", subdLevel, numVertices, (int)numVertsPerFace.size(), (unsigned long long)hash);
+	return std::string(key);
+}
+
+std::shared_ptr<const SubdivisionTopology> SubdivideFbxScene::GetSubdivisionTopology(const std::string& meshName) const
+{
+	std::lock_guard<std::mutex> lock(m_TopologyMutex);
+	auto it = m_Topology_NameLookup.find(meshName);
+	if (it == m_Topology_NameLookup.end())
+		return nullptr;
+	return it->second;
+}
+
+std::shared_ptr<SubdivisionTopology> SubdivideFbxScene::GetOrCreateTopology(const std::vector<int>& numVertsPerFace, const std::vector<int>& vertIndicesPerFace, int numVertices, int subdLevel)
+{
+	std::string key = GetTopologyKey(numVertsPerFace, vertIndicesPerFace, numVertices, subdLevel);
+	{
+		std::lock_guard<std::mutex> lock(m_TopologyMutex);
+		auto it = m_TopologyCache.find(key);
+		if (it != m_TopologyCache.end())
+		{
+			if (m_bSparseSkinWeights && it->second->CoarseToFineOffsets.empty())
+				it->second->BuildCoarseToFine();
+			m_nCacheHits++;
+			m_fCacheMillisecondsSaved += it->second->BuildMilliseconds;
+			return it->second;
+		}
+	}
+
+	// load or refine outside the lock; if another thread finished the same topology first, its result is used
+	std::shared_ptr<SubdivisionTopology> topology;
+	double fSavedMilliseconds = 0.0;
+	std::string sCacheFile = m_sCacheFolder.empty() ? std::string() : m_sCacheFolder + "/" + key + ".subdcache";
+	if (!sCacheFile.empty())
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::shared_ptr<SubdivisionTopology> cachedTopology = std::make_shared<SubdivisionTopology>();
+		if (cachedTopology->Load(sCacheFile, key) && cachedTopology->NumCoarseVerts == numVertices && cachedTopology->SubDLevel == subdLevel)
+		{
+			double fLoadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			fSavedMilliseconds = cachedTopology->BuildMilliseconds - fLoadMilliseconds;
+			topology = cachedTopology;
+		}
+	}
+	if (topology)
+	{
+		m_nCacheHits++;
+	}
+	else
+	{
+		topology = CreateTopology(numVertsPerFace, vertIndicesPerFace, numVertices, subdLevel);
+		if (!topology)
+			return nullptr;
+		m_nCacheMisses++;
+		if (!sCacheFile.empty())
+		{
+			// write to a temporary file first, so a concurrent export never reads a partial cache file
+			std::string sTempFile = sCacheFile + "." + std::to_string((unsigned long long)std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+			if (topology->Save(sTempFile, key))
+			{
+				QFile::remove(toFilePath(sCacheFile));
+				if (QFile::rename(toFilePath(sTempFile), toFilePath(sCacheFile)) == false)
+					QFile::remove(toFilePath(sTempFile));
+			}
+			else
+			{
+				QFile::remove(toFilePath(sTempFile));
+			}
+		}
+	}
+	if (m_bSparseSkinWeights)
+		topology->BuildCoarseToFine();
+
+	std::lock_guard<std::mutex> lock(m_TopologyMutex);
+	m_fCacheMillisecondsSaved += fSavedMilliseconds;
+	auto inserted = m_TopologyCache.insert(std::make_pair(key, topology));
+	return inserted.first->second;
+}
+
+double SubdivideFbxScene::GetCacheMillisecondsSaved() const
+{
+	std::lock_guard<std::mutex> lock(m_TopologyMutex);
+	return m_fCacheMillisecondsSaved;
+}
+
+std::shared_ptr<SubdivisionTopology> SubdivideFbxScene::CreateTopology(const std::vector<int>& numVertsPerFace, const std::vector<int>& vertIndicesPerFace, int numVertices, int subdLevel)
+{
+	// OpenSubdiv topology descriptor
+	typedef OpenSubdiv::Far::TopologyDescriptor Descriptor;
+	OpenSubdiv::Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
+	OpenSubdiv::Sdc::Options options;
+	options.SetVtxBoundaryInterpolation(OpenSubdiv::Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+
+	Descriptor desc;
+	desc.numVertices = numVertices;
+	desc.numFaces = (int)numVertsPerFace.size();
+	desc.numVertsPerFace = numVertsPerFace.data();
+	desc.vertIndicesPerFace = vertIndicesPerFace.data();
+
+	// Make topology refiner
+	OpenSubdiv::Far::TopologyRefiner* refiner = OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Create(
+		desc,
+		OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Options(type, options)
+	);
+	if (refiner == nullptr)
+		return nullptr;
+
+	// Refine topology
+	auto start = std::chrono::steady_clock::now();
+	refiner->RefineUniform(OpenSubdiv::Far::TopologyRefiner::UniformOptions(subdLevel));
+
+	std::shared_ptr<SubdivisionTopology> topology = std::make_shared<SubdivisionTopology>();
+	topology->SubDLevel = subdLevel;
+	topology->NumCoarseVerts = numVertices;
+	topology->NumFineVerts = refiner->GetLevel(subdLevel).GetNumVertices();
+
+	// stencils of the finest level, factorized down to the coarse vertices
+	OpenSubdiv::Far::StencilTableFactory::Options stencilOptions;
+	stencilOptions.generateIntermediateLevels = false;
+	stencilOptions.generateOffsets = true;
+	OpenSubdiv::Far::StencilTable const* stencilTable = OpenSubdiv::Far::StencilTableFactory::Create(*refiner, stencilOptions);
+	if (stencilTable == nullptr)
+	{
+		delete refiner;
+		return nullptr;
+	}
+	topology->StencilSizes = stencilTable->GetSizes();
+	topology->StencilOffsets = stencilTable->GetOffsets();
+	topology->StencilIndices = stencilTable->GetControlIndices();
+	topology->StencilWeights = stencilTable->GetWeights();
+	delete stencilTable;
+
+	// Copy the fine faces out of the refiner
+	OpenSubdiv::Far::TopologyLevel const& topo = refiner->GetLevel(subdLevel);
+	int numSubDFaces = topo.GetNumFaces();
+	topology->FineFaceOffsets.assign(numSubDFaces + 1, 0);
+	topology->FineFaceVertices.reserve(topo.GetNumFaceVertices());
+	for (int i = 0; i < numSubDFaces; i++)
+	{
+		OpenSubdiv::Far::ConstIndexArray faceVertices = topo.GetFaceVertices(i);
+		for (int j = 0; j < faceVertices.size(); j++)
+		{
+			topology->FineFaceVertices.push_back(faceVertices[j]);
+		}
+		topology->FineFaceOffsets[i + 1] = (int)topology->FineFaceVertices.size();
+	}
+	delete refiner;
+	topology->BuildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	return topology;
+}
+
+void SubdivideFbxScene::InterpolateSkinWeights(const SubdivisionTopology& topology, std::vector<ClusterWeights*>& allClusterWeights)
+{
+	int nCoarseVerts = topology.NumCoarseVerts;
+	int nFineVerts = topology.NumFineVerts;
+
+	// Each cluster is one channel of a vertex-major weight buffer, so one stencil evaluation refines all of them.
+	// Channels are only split into several passes when the buffers would exceed the budget.
+	const size_t nWeightBufferBudget = 256 * 1024 * 1024;
+	int nClusters = (int)allClusterWeights.size();
+	size_t nBytesPerChannel = std::max<size_t>(1, (size_t)(nCoarseVerts + nFineVerts) * sizeof(float));
+	int nChannelsPerPass = (int)std::min<size_t>(nClusters, std::max<size_t>(1, nWeightBufferBudget / nBytesPerChannel));
+	std::vector<float> coarseSkinWeights;
+	std::vector<float> fineSkinWeights;
+	if (nClusters > 0)
+	{
+		coarseSkinWeights.resize((size_t)nCoarseVerts * nChannelsPerPass);
+		fineSkinWeights.resize((size_t)nFineVerts * nChannelsPerPass);
+	}
+
+	for (int nFirstChannel = 0; nFirstChannel < nClusters; nFirstChannel += nChannelsPerPass)
+	{
+		int nChannels = std::min(nChannelsPerPass, nClusters - nFirstChannel);
+
+		// populate coarse skin weights
+		std::fill(coarseSkinWeights.begin(), coarseSkinWeights.begin() + (size_t)nCoarseVerts * nChannels, 0.0f);
+		for (int c = 0; c < nChannels; c++)
+		{
+			FbxCluster* lCluster = allClusterWeights[nFirstChannel + c]->SourceCluster;
+			int lIndexCount = lCluster->GetControlPointIndicesCount();
+			int* lIndices = lCluster->GetControlPointIndices();
+			double* lWeights = lCluster->GetControlPointWeights();
+			for (int k = 0; k < lIndexCount; k++)
+				coarseSkinWeights[(size_t)lIndices[k] * nChannels + c] = (float)lWeights[k];
+		}
+
+		// interpolate skin weights
+		topology.Refine(coarseSkinWeights.data(), fineSkinWeights.data(), nChannels);
+
+		for (int k = 0; k < nFineVerts; k++)
+		{
+			const float* pVertexWeights = &fineSkinWeights[(size_t)k * nChannels];
+			for (int c = 0; c < nChannels; c++)
+			{
+				float weight = pVertexWeights[c];
+				if (weight > 0.0f)
+				{
+					ClusterWeights* clusterWeights = allClusterWeights[nFirstChannel + c];
+					clusterWeights->Indices.push_back(k);
+					clusterWeights->Weights.push_back(weight);
+				}
+			}
+		}
+	}
+}
+
+void SubdivideFbxScene::InterpolateSkinWeightsSparse(const SubdivisionTopology& topology, std::vector<ClusterWeights*>& allClusterWeights)
+{
+	if (topology.CoarseToFineOffsets.empty())
+		return;
+	int nCoarseVerts = topology.NumCoarseVerts;
+	int nFineVerts = topology.NumFineVerts;
+	std::vector<int> const& stencilSizes = topology.StencilSizes;
+	std::vector<int> const& stencilOffsets = topology.StencilOffsets;
+	std::vector<int> const& stencilIndices = topology.StencilIndices;
+	std::vector<float> const& stencilWeights = topology.StencilWeights;
+	std::vector<int> const& coarseToFineOffsets = topology.CoarseToFineOffsets;
+	std::vector<int> const& coarseToFine = topology.CoarseToFine;
+
+	// The influence region of a cluster is every fine vertex whose stencil reaches one of its weighted
+	// coarse vertices, which covers the coarse vertices' one ring and everything refined from it.
+	// All other fine vertices get exactly 0 and are skipped.
+	std::vector<float> coarseWeights(nCoarseVerts, 0.0f);
+	std::vector<int> fineVertStamp(nFineVerts, -1);
+	std::vector<int> supportVerts;
+	std::vector<int> regionVerts;
+	for (int nCluster = 0; nCluster < (int)allClusterWeights.size(); nCluster++)
+	{
+		ClusterWeights* clusterWeights = allClusterWeights[nCluster];
+		FbxCluster* lCluster = clusterWeights->SourceCluster;
+		int lIndexCount = lCluster->GetControlPointIndicesCount();
+		int* lIndices = lCluster->GetControlPointIndices();
+		double* lWeights = lCluster->GetControlPointWeights();
+
+		supportVerts.clear();
+		for (int k = 0; k < lIndexCount; k++)
+		{
+			coarseWeights[lIndices[k]] = (float)lWeights[k];
+			if (lWeights[k] != 0.0)
+				supportVerts.push_back(lIndices[k]);
+		}
+
+		regionVerts.clear();
+		for (int nCoarseVert : supportVerts)
+		{
+			for (int k = coarseToFineOffsets[nCoarseVert]; k < coarseToFineOffsets[nCoarseVert + 1]; k++)
+			{
+				int nFineVert = coarseToFine[k];
+				if (fineVertStamp[nFineVert] != nCluster)
+				{
+					fineVertStamp[nFineVert] = nCluster;
+					regionVerts.push_back(nFineVert);
+				}
+			}
+		}
+		std::sort(regionVerts.begin(), regionVerts.end());
+
+		for (int nFineVert : regionVerts)
+		{
+			float weight = 0.0f;
+			for (int k = stencilOffsets[nFineVert]; k < stencilOffsets[nFineVert] + stencilSizes[nFineVert]; k++)
+				weight += stencilWeights[k] * coarseWeights[stencilIndices[k]];
+			if (weight > 0.0f)
+			{
+				clusterWeights->Indices.push_back(nFineVert);
+				clusterWeights->Weights.push_back(weight);
+			}
+		}
+
+		for (int k = 0; k < lIndexCount; k++)
+			coarseWeights[lIndices[k]] = 0.0f;
+	}
+}
+
 bool SubdivideFbxScene::SaveClustersToScene(FbxScene* pDestScene)
 {
 	FbxNode* pNode = pDestScene->GetRootNode();
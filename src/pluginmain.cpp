@@ -39,9 +39,13 @@ DZ_PLUGIN_CLASS_GUID(DzBridgeAction, 71fb7202-4b49-47ba-a82a-4780e3819776);
 #include "UnitTest_DzBridgeDialog.h"
 #include "UnitTest_DzBridgeMorphSelectionDialog.h"
 #include "UnitTest_DzBridgeSubdivisionDialog.h"
+#include "UnitTest_OpenSubdivInterface.h"
+#include "UnitTest_DzBridgeObjWriter.h"
 
 DZ_PLUGIN_CLASS_GUID(UnitTest_DzBridgeAction, 1ae818ba-d745-4db7-afb9-b1cb5e7700db);
 DZ_PLUGIN_CLASS_GUID(UnitTest_DzBridgeDialog, 15bdc1cf-fbe6-4085-b729-fcb5e428fe71);
 DZ_PLUGIN_CLASS_GUID(UnitTest_DzBridgeMorphSelectionDialog, 8d4ba27a-bb2a-4d69-95da-c8dc1b095bcc);
 DZ_PLUGIN_CLASS_GUID(UnitTest_DzBridgeSubdivisionDialog, fc3a8f28-fef2-44ed-ac99-25aadb91e3d5);
+DZ_PLUGIN_CLASS_GUID(UnitTest_OpenSubdivInterface, 6b0e2d4a-93c1-4f57-8e2a-d1c5f7a30b8e);
+DZ_PLUGIN_CLASS_GUID(UnitTest_DzBridgeObjWriter, 3e9c71b5-2a48-4d0f-b6e3-8f15a27c9d64);
 #endif